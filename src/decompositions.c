@@ -0,0 +1,491 @@
+#include "decompositions.h"
+#include "kernels.h"
+
+// Rows of the trailing submatrix updated at once, so that the matching chunk of the
+// panel stays in cache while it is applied to several columns
+#define ROW_TILE 256
+// Columns handled by a single task of the trailing update and of the solves
+#define COL_GRAIN 8
+
+// ############################### LU FACTORIZATION ####################################
+
+typedef struct Panel {
+    Matrix *a;
+    int k0;     // first column of the panel
+    int kb;     // number of columns of the panel
+} Panel;
+
+static void swap_rows(Matrix *a, int r1, int r2) {
+    for (int j = 0; j < a->cols; j++) {
+        float _Complex tmp = a->items[j].items[r1];
+        a->items[j].items[r1] = a->items[j].items[r2];
+        a->items[j].items[r2] = tmp;
+    }
+}
+
+static void lu_factorize_panel(LU *f, int k0, int kb) {
+    Matrix *a = f->lu;
+    int n = a->rows;
+    for (int k = k0; k < k0 + kb; k++) {
+        float _Complex *col = a->items[k].items;
+
+        // Partial pivoting: bring the largest element of the column onto the diagonal
+        int p = k;
+        float best = cabsf(col[k]);
+        for (int i = k + 1; i < n; i++) {
+            float curr = cabsf(col[i]);
+            if (curr > best) {
+                best = curr;
+                p = i;
+            }
+        }
+        f->pivots[k] = p;
+        if (p != k) {
+            swap_rows(a, k, p);
+            f->sign = -f->sign;
+        }
+        if (best == 0.0f) {
+            f->singular = true;
+            continue;
+        }
+
+        complex_scal(n - k - 1, 1.0f / col[k], col + k + 1);
+        for (int j = k + 1; j < k0 + kb; j++)
+            complex_axpy(n - k - 1, -a->items[j].items[k], col + k + 1, a->items[j].items + k + 1);
+    }
+}
+
+static void lu_update_trailing_columns(int start, int end, void *arg) {
+    const Panel *p = arg;
+    Matrix *a = p->a;
+    int n = a->rows;
+    int panel_end = p->k0 + p->kb;
+
+    // Triangular solve with the unit lower part of the panel (rows of U)
+    for (int j = start; j < end; j++) {
+        float _Complex *x = a->items[j].items;
+        for (int k = p->k0; k < panel_end; k++)
+            complex_axpy(panel_end - k - 1, -x[k], a->items[k].items + k + 1, x + k + 1);
+    }
+
+    // Rank-kb update of the trailing submatrix, tile by tile
+    for (int r0 = panel_end; r0 < n; r0 += ROW_TILE) {
+        int rows = min(ROW_TILE, n - r0);
+        for (int j = start; j < end; j++) {
+            float _Complex *x = a->items[j].items;
+            for (int k = p->k0; k < panel_end; k++)
+                complex_axpy(rows, -x[k], a->items[k].items + r0, x + r0);
+        }
+    }
+}
+
+LU *lu_factorize(const Matrix *m) {
+    assert(m->rows == m->cols);
+    int n = m->rows;
+
+    LU *f = malloc(sizeof(LU));
+    f->lu = matrix_copy(m);
+    f->pivots = malloc(n * sizeof(int));
+    f->sign = 1;
+    f->singular = false;
+
+    for (int k0 = 0; k0 < n; k0 += BLOCK_SIZE) {
+        int kb = min(BLOCK_SIZE, n - k0);
+        lu_factorize_panel(f, k0, kb);
+
+        Panel panel = {f->lu, k0, kb};
+        parallel_for(k0 + kb, n, COL_GRAIN, lu_update_trailing_columns, &panel);
+    }
+    return f;
+}
+
+void free_lu(LU *f) {
+    assert(f != NULL);
+    free_matrix(f->lu);
+    free(f->lu);
+    free(f->pivots);
+}
+
+float _Complex lu_determinant(const LU *f) {
+    if (f->singular)
+        return 0.0f;
+    float _Complex det = f->sign;
+    for (int k = 0; k < f->lu->rows; k++)
+        det = complex_mult(det, f->lu->items[k].items[k]);
+    return det;
+}
+
+float _Complex lu_log_determinant(const LU *f) {
+    if (f->singular)
+        return -INFINITY;
+    float log_abs = 0.0f;
+    float arg = f->sign < 0 ? M_PI : 0.0f;
+    for (int k = 0; k < f->lu->rows; k++) {
+        log_abs += logf(cabsf(f->lu->items[k].items[k]));
+        arg += cargf(f->lu->items[k].items[k]);
+    }
+    return CMPLXF(log_abs, remainderf(arg, 2 * M_PI));
+}
+
+typedef struct LUSolve {
+    const LU *f;
+    Matrix *x;
+} LUSolve;
+
+static void lu_solve_columns(int start, int end, void *arg) {
+    const LUSolve *s = arg;
+    const Matrix *a = s->f->lu;
+    Matrix *x = s->x;
+    int n = a->rows;
+
+    for (int j = start; j < end; j++) {
+        float _Complex *col = x->items[j].items;
+        for (int k = 0; k < n; k++) {
+            int p = s->f->pivots[k];
+            float _Complex tmp = col[k];
+            col[k] = col[p];
+            col[p] = tmp;
+        }
+    }
+
+    // Forward substitution with L, then backward substitution with U. Iterating over
+    // the columns of the factorization first lets every right-hand side reuse them.
+    for (int k = 0; k < n; k++)
+        for (int j = start; j < end; j++)
+            complex_axpy(n - k - 1, -x->items[j].items[k], a->items[k].items + k + 1, x->items[j].items + k + 1);
+    for (int k = n - 1; k >= 0; k--) {
+        for (int j = start; j < end; j++) {
+            float _Complex *col = x->items[j].items;
+            col[k] /= a->items[k].items[k];
+            complex_axpy(k, -col[k], a->items[k].items, col);
+        }
+    }
+}
+
+Matrix *lu_solve(const LU *f, const Matrix *b) {
+    assert(f->lu->rows == b->rows);
+    if (f->singular) {
+        fprintf(stderr, "lu_solve: singular matrix\n");
+        errno = EDOM;
+        return NULL;
+    }
+
+    Matrix *x = matrix_copy(b);
+    LUSolve s = {f, x};
+    parallel_for(0, x->cols, COL_GRAIN, lu_solve_columns, &s);
+    return x;
+}
+
+Matrix *lu_inverse(const LU *f) {
+    Matrix *id = identity_matrix(f->lu->rows);
+    Matrix *inv = lu_solve(f, id);
+    free_matrix(id);
+    free(id);
+    return inv;
+}
+
+// ############################ CHOLESKY FACTORIZATION #################################
+
+static void cholesky_update_trailing_columns(int start, int end, void *arg) {
+    const Panel *p = arg;
+    Matrix *a = p->a;
+    int n = a->rows;
+    int panel_end = p->k0 + p->kb;
+
+    // A22 -= L21 L21^H, restricted to the lower triangle and applied tile by tile
+    for (int r0 = start; r0 < n; r0 += ROW_TILE) {
+        for (int j = start; j < end; j++) {
+            int first = max(r0, j);
+            int rows = min(r0 + ROW_TILE, n) - first;
+            if (rows <= 0)
+                continue;
+            float _Complex *x = a->items[j].items;
+            for (int k = p->k0; k < panel_end; k++)
+                complex_axpy(rows, -conjf(a->items[k].items[j]), a->items[k].items + first, x + first);
+        }
+    }
+}
+
+int cholesky_factorize_inplace(Matrix *m) {
+    assert(m->rows == m->cols);
+    int n = m->rows;
+
+    for (int k0 = 0; k0 < n; k0 += BLOCK_SIZE) {
+        int kb = min(BLOCK_SIZE, n - k0);
+        for (int k = k0; k < k0 + kb; k++) {
+            float _Complex *col = m->items[k].items;
+            float d = crealf(col[k]);
+            if (!(d > 0.0f) || !isfinite(d)) {
+                fprintf(stderr, "cholesky_factorize: matrix is not positive definite\n");
+                errno = EDOM;
+                return DECOMPOSITION_ERR_NOT_POSITIVE_DEFINITE;
+            }
+            float l = sqrtf(d);
+            col[k] = l;
+            complex_scal(n - k - 1, 1.0f / l, col + k + 1);
+            for (int j = k + 1; j < k0 + kb; j++)
+                complex_axpy(n - j, -conjf(col[j]), col + j, m->items[j].items + j);
+        }
+
+        Panel panel = {m, k0, kb};
+        parallel_for(k0 + kb, n, COL_GRAIN, cholesky_update_trailing_columns, &panel);
+    }
+
+    for (int j = 1; j < n; j++)
+        memset(m->items[j].items, 0, j * sizeof *m->items[j].items);
+    return DECOMPOSITION_SUCCESS;
+}
+
+Matrix *cholesky_factorize(const Matrix *m) {
+    Matrix *l = matrix_copy(m);
+    if (cholesky_factorize_inplace(l) != DECOMPOSITION_SUCCESS) {
+        free_matrix(l);
+        free(l);
+        return NULL;
+    }
+    return l;
+}
+
+typedef struct CholeskySolve {
+    const Matrix *l;
+    Matrix *x;
+} CholeskySolve;
+
+static void cholesky_solve_columns(int start, int end, void *arg) {
+    const CholeskySolve *s = arg;
+    const Matrix *l = s->l;
+    Matrix *x = s->x;
+    int n = l->rows;
+
+    // Forward substitution with L, then backward substitution with L^H
+    for (int k = 0; k < n; k++) {
+        for (int j = start; j < end; j++) {
+            float _Complex *col = x->items[j].items;
+            col[k] /= l->items[k].items[k];
+            complex_axpy(n - k - 1, -col[k], l->items[k].items + k + 1, col + k + 1);
+        }
+    }
+    for (int k = n - 1; k >= 0; k--) {
+        for (int j = start; j < end; j++) {
+            float _Complex *col = x->items[j].items;
+            col[k] -= complex_dotc(n - k - 1, l->items[k].items + k + 1, col + k + 1);
+            col[k] /= l->items[k].items[k];
+        }
+    }
+}
+
+Matrix *cholesky_solve(const Matrix *l, const Matrix *b) {
+    assert(l->rows == l->cols && l->rows == b->rows);
+    Matrix *x = matrix_copy(b);
+    CholeskySolve s = {l, x};
+    parallel_for(0, x->cols, COL_GRAIN, cholesky_solve_columns, &s);
+    return x;
+}
+
+// ############################### QR FACTORIZATION ####################################
+
+typedef struct QRPanel {
+    const QR *f;
+    Matrix *c;      // matrix the block reflector is applied to
+    int k0;
+    int kb;
+    bool adjoint;   // apply (I - V T V^H)^H instead of I - V T V^H
+} QRPanel;
+
+float _Complex householder_reflector(int n, float _Complex *x) {
+    float xnorm = 0.0f;
+    for (int i = 1; i < n; i++)
+        xnorm = hypotf(xnorm, cabsf(x[i]));
+    float alphr = crealf(x[0]), alphi = cimagf(x[0]);
+    if (xnorm == 0.0f && alphi == 0.0f)
+        return 0.0f;
+
+    float beta = -copysignf(hypotf(cabsf(x[0]), xnorm), alphr);
+    float _Complex tau = CMPLXF((beta - alphr) / beta, -alphi / beta);
+    complex_scal(n - 1, 1.0f / (x[0] - beta), x + 1);
+    x[0] = beta;
+    return tau;
+}
+
+// Compute the i-th entry of V^H c, V being the reflectors of the panel
+static inline float _Complex reflector_dot(const Matrix *v, int k, const float _Complex *c) {
+    int m = v->rows;
+    return c[k] + complex_dotc(m - k - 1, v->items[k].items + k + 1, c + k + 1);
+}
+
+static void qr_apply_block_reflector(int start, int end, void *arg) {
+    const QRPanel *p = arg;
+    const Matrix *v = p->f->qr;
+    const Matrix *t = p->f->t;
+    int m = v->rows;
+    float _Complex w[BLOCK_SIZE];
+
+    for (int j = start; j < end; j++) {
+        float _Complex *c = p->c->items[j].items;
+        for (int i = 0; i < p->kb; i++)
+            w[i] = reflector_dot(v, p->k0 + i, c);
+
+        // w = T^H w (lower triangular, in place from the bottom) or w = T w (upper
+        // triangular, in place from the top)
+        if (p->adjoint) {
+            for (int i = p->kb - 1; i >= 0; i--) {
+                float _Complex sum = 0.0f;
+                for (int l = 0; l <= i; l++)
+                    sum += complex_mult(conjf(t->items[p->k0 + i].items[l]), w[l]);
+                w[i] = sum;
+            }
+        } else {
+            for (int i = 0; i < p->kb; i++) {
+                float _Complex sum = 0.0f;
+                for (int l = i; l < p->kb; l++)
+                    sum += complex_mult(t->items[p->k0 + l].items[i], w[l]);
+                w[i] = sum;
+            }
+        }
+
+        for (int i = 0; i < p->kb; i++) {
+            int k = p->k0 + i;
+            c[k] -= w[i];
+            complex_axpy(m - k - 1, -w[i], v->items[k].items + k + 1, c + k + 1);
+        }
+    }
+}
+
+static void qr_factorize_panel(QR *f, int k0, int kb) {
+    Matrix *a = f->qr;
+    Matrix *t = f->t;
+    int m = a->rows;
+
+    for (int k = k0; k < k0 + kb; k++) {
+        float _Complex *v = a->items[k].items;
+        float _Complex tau = householder_reflector(m - k, v + k);
+        f->tau[k] = tau;
+
+        // Apply H^H = I - conj(tau) v v^H to the remaining columns of the panel
+        for (int j = k + 1; j < k0 + kb; j++) {
+            float _Complex *c = a->items[j].items;
+            float _Complex s = complex_mult(conjf(tau), reflector_dot(a, k, c));
+            c[k] -= s;
+            complex_axpy(m - k - 1, -s, v + k + 1, c + k + 1);
+        }
+
+        // Column k - k0 of T: -tau T (V^H v) above the diagonal, tau on it
+        int i = k - k0;
+        float _Complex *tcol = t->items[k].items;
+        for (int l = 0; l < i; l++)
+            tcol[l] = complex_mult(-tau, conjf(a->items[k0 + l].items[k])
+                + complex_dotc(m - k - 1, a->items[k0 + l].items + k + 1, v + k + 1));
+        for (int r = 0; r < i; r++) {
+            float _Complex sum = 0.0f;
+            for (int l = r; l < i; l++)
+                sum += complex_mult(t->items[k0 + l].items[r], tcol[l]);
+            tcol[r] = sum;
+        }
+        tcol[i] = tau;
+    }
+}
+
+QR *qr_factorize_inplace(Matrix *m) {
+    int kmax = min(m->rows, m->cols);
+
+    QR *f = malloc(sizeof(QR));
+    f->qr = m;
+    f->t = malloc(sizeof(Matrix));
+    init_matrix(f->t, "T", BLOCK_SIZE, kmax);
+    f->tau = calloc(kmax, sizeof *f->tau);
+    f->owns_qr = false;
+
+    for (int k0 = 0; k0 < kmax; k0 += BLOCK_SIZE) {
+        int kb = min(BLOCK_SIZE, kmax - k0);
+        qr_factorize_panel(f, k0, kb);
+
+        QRPanel panel = {f, m, k0, kb, true};
+        parallel_for(k0 + kb, m->cols, COL_GRAIN, qr_apply_block_reflector, &panel);
+    }
+    return f;
+}
+
+QR *qr_factorize(const Matrix *m) {
+    QR *f = qr_factorize_inplace(matrix_copy(m));
+    f->owns_qr = true;
+    return f;
+}
+
+void free_qr(QR *f) {
+    assert(f != NULL);
+    if (f->owns_qr) {
+        free_matrix(f->qr);
+        free(f->qr);
+    }
+    free_matrix(f->t);
+    free(f->t);
+    free(f->tau);
+}
+
+void qr_apply_qh(const QR *f, Matrix *b) {
+    assert(b->rows == f->qr->rows);
+    int kmax = min(f->qr->rows, f->qr->cols);
+    for (int k0 = 0; k0 < kmax; k0 += BLOCK_SIZE) {
+        QRPanel panel = {f, b, k0, min(BLOCK_SIZE, kmax - k0), true};
+        parallel_for(0, b->cols, COL_GRAIN, qr_apply_block_reflector, &panel);
+    }
+}
+
+void qr_apply_q(const QR *f, Matrix *b) {
+    assert(b->rows == f->qr->rows);
+    int kmax = min(f->qr->rows, f->qr->cols);
+    for (int k0 = (kmax - 1) / BLOCK_SIZE * BLOCK_SIZE; k0 >= 0; k0 -= BLOCK_SIZE) {
+        QRPanel panel = {f, b, k0, min(BLOCK_SIZE, kmax - k0), false};
+        parallel_for(0, b->cols, COL_GRAIN, qr_apply_block_reflector, &panel);
+    }
+}
+
+Matrix *qr_q(const QR *f) {
+    int kmax = min(f->qr->rows, f->qr->cols);
+    Matrix *q = malloc(sizeof(Matrix));
+    init_matrix(q, "Q", f->qr->rows, kmax);
+    for (int i = 0; i < kmax; i++)
+        update_matrix(q, 1.0f, i, i);
+    qr_apply_q(f, q);
+    return q;
+}
+
+Matrix *qr_r(const QR *f) {
+    int kmax = min(f->qr->rows, f->qr->cols);
+    Matrix *r = malloc(sizeof(Matrix));
+    init_matrix(r, "R", kmax, f->qr->cols);
+    for (int j = 0; j < r->cols; j++)
+        memcpy(r->items[j].items, f->qr->items[j].items, min(j + 1, kmax) * sizeof *r->items[j].items);
+    return r;
+}
+
+Matrix *qr_least_squares(const QR *f, const Matrix *b) {
+    const Matrix *a = f->qr;
+    int n = a->cols;
+    assert(a->rows >= n && b->rows == a->rows);
+    for (int k = 0; k < n; k++) {
+        if (a->items[k].items[k] == 0.0f) {
+            fprintf(stderr, "qr_least_squares: rank deficient matrix\n");
+            errno = EDOM;
+            return NULL;
+        }
+    }
+
+    Matrix *y = matrix_copy(b);
+    qr_apply_qh(f, y);
+
+    // Backward substitution with the leading n x n block of R
+    Matrix *x = malloc(sizeof(Matrix));
+    init_matrix(x, "X", n, b->cols);
+    for (int j = 0; j < b->cols; j++) {
+        float _Complex *col = x->items[j].items;
+        memcpy(col, y->items[j].items, n * sizeof *col);
+        for (int k = n - 1; k >= 0; k--) {
+            col[k] /= a->items[k].items[k];
+            complex_axpy(k, -col[k], a->items[k].items, col);
+        }
+    }
+    free_matrix(y);
+    free(y);
+    return x;
+}
@@ -0,0 +1,203 @@
+#ifndef DECOMPOSITIONS_HEADER
+#define DECOMPOSITIONS_HEADER
+
+#include "matrix.h"
+
+// Number of columns factorised per panel by the blocked algorithms
+#define BLOCK_SIZE 64
+
+enum {
+    DECOMPOSITION_SUCCESS = 0,
+    DECOMPOSITION_ERR_NOT_POSITIVE_DEFINITE = -1
+};
+
+// LU factorization PA = LU, stored in place: U on and above the diagonal, the unit
+// lower triangular L below it
+typedef struct LU {
+    Matrix *lu;
+    int *pivots;    // row k was swapped with row pivots[k] at step k
+    int sign;       // sign of the permutation P
+    bool singular;
+} LU;
+
+// Householder QR factorization A = QR with Q = H_1 H_2 ... H_k and H_i = I - tau_i v_i v_i^H.
+// R is stored on and above the diagonal, the reflectors v_i below it (their leading 1
+// is implicit). Each panel of BLOCK_SIZE reflectors is also kept in compact WY form
+// I - V T V^H, the upper triangular T of the panel starting at column k0 being stored
+// in rows 0 to BLOCK_SIZE-1 of columns k0 onwards of t.
+typedef struct QR {
+    Matrix *qr;
+    Matrix *t;
+    float _Complex *tau;
+    bool owns_qr;   // whether qr is freed along with the factorization
+} QR;
+
+// ############################### LU FACTORIZATION ####################################
+
+/**
+ * @brief compute the LU factorization with partial pivoting of a square matrix
+ *
+ * Blocked right-looking algorithm: each panel of BLOCK_SIZE columns is factorised,
+ * then the trailing submatrix is updated in parallel tiles, in O(n^3) time overall.
+ *
+ * @param m square matrix
+ * @return LU* factorization, to be reused for determinants, inverses and solves
+ */
+LU *lu_factorize(const Matrix *m);
+
+/**
+ * @brief remove an LU factorization from memory
+ *
+ * @param f factorization
+ */
+void free_lu(LU *f);
+
+/**
+ * @brief compute the determinant of a factorised matrix
+ *
+ * @param f factorization
+ * @return float _Complex the determinant
+ */
+float _Complex lu_determinant(const LU *f);
+
+/**
+ * @brief compute the logarithm of the determinant of a factorised matrix
+ *
+ * The real part is log|det| and the imaginary part the argument of the determinant,
+ * which avoids the overflow of lu_determinant for large matrices.
+ *
+ * @param f factorization
+ * @return float _Complex the log-determinant (-inf if the matrix is singular)
+ */
+float _Complex lu_log_determinant(const LU *f);
+
+/**
+ * @brief solve the system AX = B for every column of B
+ *
+ * @param f factorization of A
+ * @param b right-hand sides
+ * @return Matrix* the solutions X, or NULL if A is singular
+ */
+Matrix *lu_solve(const LU *f, const Matrix *b);
+
+/**
+ * @brief compute the inverse of a factorised matrix
+ *
+ * @param f factorization
+ * @return Matrix* the inverse, or NULL if the matrix is singular
+ */
+Matrix *lu_inverse(const LU *f);
+
+// ############################ CHOLESKY FACTORIZATION #################################
+
+/**
+ * @brief compute the Cholesky factorization A = LL^H of a Hermitian positive-definite
+ * matrix, overwriting it with L
+ *
+ * Only the lower triangle of m is read, the upper one is set to zero. The trailing
+ * submatrix of every panel is updated in parallel.
+ *
+ * @param m Hermitian positive-definite matrix
+ * @return int status of the factorization (0 for success, negative int if m is not
+ *         positive definite, in which case m is left partially overwritten)
+ */
+int cholesky_factorize_inplace(Matrix *m);
+
+/**
+ * @brief compute the Cholesky factorization A = LL^H of a Hermitian positive-definite matrix
+ *
+ * @param m Hermitian positive-definite matrix
+ * @return Matrix* the lower triangular factor L, or NULL if m is not positive definite
+ */
+Matrix *cholesky_factorize(const Matrix *m);
+
+/**
+ * @brief solve the system LL^H X = B for every column of B
+ *
+ * @param l Cholesky factor
+ * @param b right-hand sides
+ * @return Matrix* the solutions X
+ */
+Matrix *cholesky_solve(const Matrix *l, const Matrix *b);
+
+// ############################### QR FACTORIZATION ####################################
+
+/**
+ * @brief generate an elementary reflector H = I - tau v v^H such that H^H x = (beta, 0, ..., 0)
+ *
+ * x is overwritten with beta followed by v (whose leading 1 is implicit), beta being real.
+ *
+ * @param n length of x
+ * @param x vector to reflect
+ * @return float _Complex tau (0 if H is the identity)
+ */
+float _Complex householder_reflector(int n, float _Complex *x);
+
+/**
+ * @brief compute the Householder QR factorization of a matrix, overwriting it
+ *
+ * The returned factorization stores R and the reflectors in m itself, which must
+ * outlive it and is not freed by free_qr.
+ *
+ * @param m matrix of any shape
+ * @return QR* factorization
+ */
+QR *qr_factorize_inplace(Matrix *m);
+
+/**
+ * @brief compute the Householder QR factorization of a matrix
+ *
+ * @param m matrix of any shape
+ * @return QR* factorization
+ */
+QR *qr_factorize(const Matrix *m);
+
+/**
+ * @brief remove a QR factorization from memory
+ *
+ * @param f factorization
+ */
+void free_qr(QR *f);
+
+/**
+ * @brief overwrite B with Q^H B, applying one block reflector per panel
+ *
+ * @param f factorization
+ * @param b matrix with as many rows as the factorised matrix
+ */
+void qr_apply_qh(const QR *f, Matrix *b);
+
+/**
+ * @brief overwrite B with Q B, applying one block reflector per panel
+ *
+ * @param f factorization
+ * @param b matrix with as many rows as the factorised matrix
+ */
+void qr_apply_q(const QR *f, Matrix *b);
+
+/**
+ * @brief form the first min(rows, cols) columns of Q
+ *
+ * @param f factorization
+ * @return Matrix* thin orthonormal factor
+ */
+Matrix *qr_q(const QR *f);
+
+/**
+ * @brief extract the first min(rows, cols) rows of R
+ *
+ * @param f factorization
+ * @return Matrix* upper triangular factor
+ */
+Matrix *qr_r(const QR *f);
+
+/**
+ * @brief solve the least-squares problem min ||AX - B|| for every column of B
+ *
+ * @param f factorization of A, which must have at least as many rows as columns
+ * @param b right-hand sides
+ * @return Matrix* the solutions X, or NULL if A is rank deficient
+ */
+Matrix *qr_least_squares(const QR *f, const Matrix *b);
+
+#endif
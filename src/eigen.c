@@ -0,0 +1,512 @@
+#include "eigen.h"
+#include "kernels.h"
+#include <float.h>
+
+// Columns (respectively rows) handled by a single task of the parallel updates
+#define COL_GRAIN 8
+#define ROW_GRAIN 256
+
+#define H(i, j) h->items[j].items[i]
+
+// ############################## REFLECTOR APPLICATION ################################
+
+// Elementary reflector H = I - tau v v^H acting on rows [offset, rows) of a
+typedef struct Reflector {
+    Matrix *a;
+    const float _Complex *v;    // reflector, including its leading 1
+    float _Complex tau;
+    int offset;
+    float _Complex *w;          // workspace of the right application
+    bool adjoint;               // apply H^H instead of H from the left
+} Reflector;
+
+static void reflect_columns_left(int start, int end, void *arg) {
+    const Reflector *r = arg;
+    int len = r->a->rows - r->offset;
+    float _Complex tau = r->adjoint ? conjf(r->tau) : r->tau;
+    for (int j = start; j < end; j++) {
+        float _Complex *c = r->a->items[j].items + r->offset;
+        float _Complex s = complex_mult(tau, complex_dotc(len, r->v, c));
+        complex_axpy(len, -s, r->v, c);
+    }
+}
+
+// w = A[:, offset:] v, computed by chunks of rows
+static void reflector_product_rows(int start, int end, void *arg) {
+    const Reflector *r = arg;
+    memset(r->w + start, 0, (end - start) * sizeof *r->w);
+    for (int j = r->offset; j < r->a->cols; j++)
+        complex_axpy(end - start, r->v[j - r->offset], r->a->items[j].items + start, r->w + start);
+}
+
+// A[:, offset:] -= (A v) tau v^H, once w = A v is known
+static void reflect_columns_right(int start, int end, void *arg) {
+    const Reflector *r = arg;
+    for (int j = start; j < end; j++)
+        complex_axpy(r->a->rows, -complex_mult(r->tau, conjf(r->v[j - r->offset])), r->w, r->a->items[j].items);
+}
+
+// Form Q = H_0 H_1 ... from the reflectors stored below the subdiagonal of a
+static Matrix *accumulate_reflectors(const Matrix *a, const float _Complex *tau, int count) {
+    int n = a->rows;
+    Matrix *q = identity_matrix(n);
+    float _Complex *v = malloc(n * sizeof *v);
+    for (int k = count - 1; k >= 0; k--) {
+        if (tau[k] == 0.0f)
+            continue;
+        v[0] = 1.0f;
+        memcpy(v + 1, a->items[k].items + k + 2, (n - k - 2) * sizeof *v);
+        Reflector r = {q, v, tau[k], k + 1, NULL, false};
+        parallel_for(k + 1, n, COL_GRAIN, reflect_columns_left, &r);
+    }
+    free(v);
+    return q;
+}
+
+// ############################### GENERAL MATRICES ####################################
+
+static inline float cabs1(float _Complex z) {
+    return fabsf(crealf(z)) + fabsf(cimagf(z));
+}
+
+// Reduce a to upper Hessenberg form Q^H A Q in place, returning Q if requested
+static Matrix *hessenberg_reduce(Matrix *a, bool want_q) {
+    int n = a->rows;
+    float _Complex *tau = calloc(n, sizeof *tau);
+    float _Complex *v = malloc(n * sizeof *v);
+    float _Complex *w = malloc(n * sizeof *w);
+
+    for (int k = 0; k < n - 2; k++) {
+        float _Complex *col = a->items[k].items;
+        tau[k] = householder_reflector(n - k - 1, col + k + 1);
+        if (tau[k] == 0.0f)
+            continue;
+        v[0] = 1.0f;
+        memcpy(v + 1, col + k + 2, (n - k - 2) * sizeof *v);
+
+        Reflector r = {a, v, tau[k], k + 1, w, true};
+        parallel_for(k + 1, n, COL_GRAIN, reflect_columns_left, &r);
+        parallel_for(0, n, ROW_GRAIN, reflector_product_rows, &r);
+        parallel_for(k + 1, n, COL_GRAIN, reflect_columns_right, &r);
+    }
+
+    Matrix *q = want_q ? accumulate_reflectors(a, tau, max(n - 2, 0)) : NULL;
+    for (int k = 0; k < n - 2; k++)
+        memset(a->items[k].items + k + 2, 0, (n - k - 2) * sizeof *v);
+    free(tau);
+    free(v);
+    free(w);
+    return q;
+}
+
+// Compute the rotation G = [c s; -conj(s) c] such that G (x, y) = (r, 0)
+static void givens_rotation(float _Complex x, float _Complex y, float *c, float _Complex *s) {
+    float ax = cabsf(x);
+    float norm = hypotf(ax, cabsf(y));
+    if (ax == 0.0f) {
+        *c = 0.0f;
+        *s = 1.0f;
+        return;
+    }
+    *c = ax / norm;
+    *s = complex_mult(x / ax, conjf(y)) / norm;
+}
+
+// Rotate columns k and k+1 of m over rows [first, last]: M <- M G^H
+static void rotate_columns(Matrix *m, int k, int first, int last, float c, float _Complex s) {
+    float _Complex *u = m->items[k].items;
+    float _Complex *v = m->items[k + 1].items;
+    float _Complex sc = conjf(s);
+    for (int i = first; i <= last; i++) {
+        float _Complex t1 = u[i], t2 = v[i];
+        u[i] = c * t1 + complex_mult(sc, t2);
+        v[i] = c * t2 - complex_mult(s, t1);
+    }
+}
+
+// Compute the Wilkinson shift: the eigenvalue of the trailing 2x2 block closest to its last element
+static float _Complex wilkinson_shift(const Matrix *h, int hi) {
+    float _Complex a = H(hi - 1, hi - 1), b = H(hi - 1, hi);
+    float _Complex c = H(hi, hi - 1), d = H(hi, hi);
+    float _Complex half_trace = (a + d) / 2.0f;
+    float _Complex disc = csqrtf(complex_mult(half_trace, half_trace) - complex_mult(a, d) + complex_mult(b, c));
+    float _Complex mu1 = half_trace + disc, mu2 = half_trace - disc;
+    return cabs1(mu1 - d) < cabs1(mu2 - d) ? mu1 : mu2;
+}
+
+// Reduce the Hessenberg matrix h to upper triangular Schur form with single-shift QR
+// sweeps, storing the eigenvalues in w. When the Schur form is not needed (want_t false),
+// only the active window of h is updated.
+static bool schur_reduce(Matrix *h, Matrix *z, bool want_t, float _Complex *w) {
+    int n = h->rows;
+    int hi = n - 1;
+    int its = 0;
+
+    while (hi >= 0) {
+        // Look for a negligible subdiagonal element to split the problem
+        int l;
+        for (l = hi; l > 0; l--) {
+            float sub = cabs1(H(l, l - 1));
+            if (sub <= FLT_EPSILON * (cabs1(H(l - 1, l - 1)) + cabs1(H(l, l))) || sub < FLT_MIN)
+                break;
+        }
+        if (l > 0)
+            H(l, l - 1) = 0.0f;
+        if (l == hi) {
+            w[hi] = H(hi, hi);
+            hi--;
+            its = 0;
+            continue;
+        }
+        if (++its > MAX_EIGEN_ITERATIONS)
+            return false;
+
+        // Exceptional shifts get the iterations out of rare cycles
+        float _Complex mu = its % 10 == 0
+            ? H(hi, hi) + 0.75f * fabsf(crealf(H(hi, hi - 1)))
+            : wilkinson_shift(h, hi);
+
+        int jlo = want_t ? 0 : l;
+        int jhi = want_t ? n - 1 : hi;
+        float _Complex x = H(l, l) - mu, y = H(l + 1, l);
+        for (int k = l; k < hi; k++) {
+            if (k > l) {
+                x = H(k, k - 1);
+                y = H(k + 1, k - 1);
+            }
+            float c;
+            float _Complex s;
+            givens_rotation(x, y, &c, &s);
+
+            // H <- G H on rows k and k+1
+            for (int j = (k > l ? k - 1 : l); j <= jhi; j++) {
+                float _Complex t1 = H(k, j), t2 = H(k + 1, j);
+                H(k, j) = c * t1 + complex_mult(s, t2);
+                H(k + 1, j) = c * t2 - complex_mult(conjf(s), t1);
+            }
+            if (k > l)
+                H(k + 1, k - 1) = 0.0f;
+
+            // H <- H G^H on columns k and k+1, Z <- Z G^H
+            rotate_columns(h, k, jlo, min(k + 2, hi), c, s);
+            if (z != NULL)
+                rotate_columns(z, k, 0, n - 1, c, s);
+        }
+    }
+    return true;
+}
+
+typedef struct SchurVectors {
+    const Matrix *t;
+    const Matrix *z;
+    Matrix *v;
+    float smin;     // smallest allowed pivot of the back substitutions
+} SchurVectors;
+
+// Solve (T - t_kk I) x = 0 by back substitution, then map x back with Z
+static void schur_eigenvectors(int start, int end, void *arg) {
+    const SchurVectors *s = arg;
+    const Matrix *t = s->t;
+    int n = t->rows;
+    float _Complex *x = malloc(n * sizeof *x);
+
+    for (int k = start; k < end; k++) {
+        float _Complex lambda = t->items[k].items[k];
+        for (int i = 0; i < k; i++)
+            x[i] = -t->items[k].items[i];
+        x[k] = 1.0f;
+        for (int i = k - 1; i >= 0; i--) {
+            float _Complex pivot = t->items[i].items[i] - lambda;
+            if (cabs1(pivot) < s->smin)
+                pivot = s->smin;
+            x[i] /= pivot;
+            complex_axpy(i, -x[i], t->items[i].items, x);
+        }
+
+        float _Complex *col = s->v->items[k].items;
+        for (int i = 0; i <= k; i++)
+            complex_axpy(n, x[i], s->z->items[i].items, col);
+        float norm = sqrtf(crealf(complex_dotc(n, col, col)));
+        complex_scal(n, 1.0f / norm, col);
+    }
+    free(x);
+}
+
+Eigen *matrix_eigen(const Matrix *m, bool vectors) {
+    assert(m->rows == m->cols);
+    int n = m->rows;
+
+    Matrix *h = matrix_copy(m);
+    Matrix *z = hessenberg_reduce(h, vectors);
+
+    Eigen *e = malloc(sizeof(Eigen));
+    e->values = malloc(sizeof(Vector));
+    init_vector(e->values, "E", n);
+    e->vectors = NULL;
+
+    if (!schur_reduce(h, z, vectors, e->values->items)) {
+        fprintf(stderr, "matrix_eigen: QR iterations did not converge\n");
+        errno = EDOM;
+        free_eigen(e);
+        free(e);
+        e = NULL;
+    } else if (vectors) {
+        float tnorm = 0.0f;
+        for (int j = 0; j < n; j++)
+            for (int i = 0; i <= j; i++)
+                tnorm = max(tnorm, cabs1(h->items[j].items[i]));
+
+        e->vectors = malloc(sizeof(Matrix));
+        init_matrix(e->vectors, "V", n, n);
+        SchurVectors s = {h, z, e->vectors, max(FLT_EPSILON * tnorm, FLT_MIN)};
+        parallel_for(0, n, COL_GRAIN, schur_eigenvectors, &s);
+    }
+
+    free_matrix(h);
+    free(h);
+    if (z != NULL) {
+        free_matrix(z);
+        free(z);
+    }
+    return e;
+}
+
+// ############################### HERMITIAN MATRICES ##################################
+
+// Symmetric rank-2 update A22 -= v w^H + w v^H of the trailing submatrix
+typedef struct RankTwoUpdate {
+    Matrix *a;
+    const float _Complex *v;
+    const float _Complex *w;
+    int offset;
+} RankTwoUpdate;
+
+static void rank_two_update_columns(int start, int end, void *arg) {
+    const RankTwoUpdate *u = arg;
+    int len = u->a->rows - u->offset;
+    for (int j = start; j < end; j++) {
+        float _Complex *c = u->a->items[j].items + u->offset;
+        complex_axpy(len, -conjf(u->w[j - u->offset]), u->v, c);
+        complex_axpy(len, -conjf(u->v[j - u->offset]), u->w, c);
+    }
+}
+
+// Reduce the Hermitian matrix a to real tridiagonal form (d, e) with Householder
+// reflectors, returning Q if requested
+static Matrix *tridiagonal_reduce(Matrix *a, double *d, double *e, bool want_q) {
+    int n = a->rows;
+    float _Complex *tau = calloc(n, sizeof *tau);
+    float _Complex *v = malloc(n * sizeof *v);
+    float _Complex *p = malloc(n * sizeof *p);
+
+    for (int k = 0; k < n - 1; k++) {
+        float _Complex *col = a->items[k].items;
+        int len = n - k - 1;
+        // Reflecting a single element makes the last subdiagonal element real
+        tau[k] = householder_reflector(len, col + k + 1);
+        d[k] = crealf(col[k]);
+        e[k] = crealf(col[k + 1]);
+        if (tau[k] == 0.0f)
+            continue;
+        v[0] = 1.0f;
+        memcpy(v + 1, col + k + 2, (len - 1) * sizeof *v);
+
+        // p = tau A22 v, then w = p - tau/2 (p^H v) v
+        Reflector r = {a, v, tau[k], k + 1, p, false};
+        parallel_for(k + 1, n, ROW_GRAIN, reflector_product_rows, &r);
+        complex_scal(len, tau[k], p + k + 1);
+        float _Complex alpha = complex_mult(-0.5f * tau[k], complex_dotc(len, p + k + 1, v));
+        complex_axpy(len, alpha, v, p + k + 1);
+
+        RankTwoUpdate u = {a, v, p + k + 1, k + 1};
+        parallel_for(k + 1, n, COL_GRAIN, rank_two_update_columns, &u);
+    }
+    d[n - 1] = crealf(a->items[n - 1].items[n - 1]);
+    e[n - 1] = 0.0;
+
+    Matrix *q = want_q ? accumulate_reflectors(a, tau, n - 1) : NULL;
+    free(tau);
+    free(v);
+    free(p);
+    return q;
+}
+
+// Plane rotations of one QL sweep, applied to the rows of the eigenvector matrix
+typedef struct Rotations {
+    float *z;       // row-major eigenvectors of the tridiagonal matrix
+    int n;
+    const double *c;
+    const double *s;
+    int first;      // rotations act on columns (i, i+1) for i from last down to first
+    int last;
+} Rotations;
+
+static void rotate_rows(int start, int end, void *arg) {
+    const Rotations *r = arg;
+    for (int k = start; k < end; k++) {
+        float *row = r->z + (size_t) k * r->n;
+        for (int i = r->last; i >= r->first; i--) {
+            float f = row[i + 1];
+            row[i + 1] = r->s[i] * row[i] + r->c[i] * f;
+            row[i] = r->c[i] * row[i] - r->s[i] * f;
+        }
+    }
+}
+
+// Diagonalise the symmetric tridiagonal matrix (d, e) with implicit QL iterations and
+// Wilkinson shifts, accumulating the rotations in z if it is not NULL
+static bool tridiagonal_ql(double *d, double *e, float *z, int n) {
+    double *cs = malloc(n * sizeof *cs);
+    double *ss = malloc(n * sizeof *ss);
+    bool converged = true;
+
+    for (int l = 0; l < n && converged; l++) {
+        int iter = 0;
+        int m;
+        do {
+            for (m = l; m < n - 1; m++)
+                if (fabs(e[m]) <= DBL_EPSILON * (fabs(d[m]) + fabs(d[m + 1])))
+                    break;
+            if (m == l)
+                break;
+            if (iter++ == MAX_EIGEN_ITERATIONS) {
+                converged = false;
+                break;
+            }
+
+            double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+            double r = hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + copysign(r, g));
+            double s = 1.0, c = 1.0, p = 0.0;
+            int i;
+            for (i = m - 1; i >= l; i--) {
+                double f = s * e[i];
+                double b = c * e[i];
+                e[i + 1] = r = hypot(f, g);
+                if (r == 0.0) {
+                    // Recover from underflow
+                    d[i + 1] -= p;
+                    e[m] = 0.0;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2.0 * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+                cs[i] = c;
+                ss[i] = s;
+            }
+            if (z != NULL) {
+                Rotations rot = {z, n, cs, ss, i + 1, m - 1};
+                parallel_for(0, n, ROW_GRAIN, rotate_rows, &rot);
+            }
+            if (r == 0.0 && i >= l)
+                continue;
+            d[l] -= p;
+            e[l] = g;
+            e[m] = 0.0;
+        } while (m != l);
+    }
+    free(cs);
+    free(ss);
+    return converged;
+}
+
+// Columns of V = Q Z for the eigenvalues in ascending order
+typedef struct TridiagonalVectors {
+    const Matrix *q;
+    const float *z;
+    const int *order;
+    Matrix *v;
+} TridiagonalVectors;
+
+static void tridiagonal_eigenvectors(int start, int end, void *arg) {
+    const TridiagonalVectors *t = arg;
+    int n = t->q->rows;
+    for (int j = start; j < end; j++)
+        for (int i = 0; i < n; i++)
+            complex_axpy(n, t->z[(size_t) i * n + t->order[j]], t->q->items[i].items, t->v->items[j].items);
+}
+
+Eigen *matrix_hermitian_eigen(const Matrix *m, bool vectors) {
+    assert(m->rows == m->cols);
+    int n = m->rows;
+
+    // Only the lower triangle is trusted: mirror it onto the upper one
+    Matrix *a = matrix_copy(m);
+    for (int j = 0; j < n; j++) {
+        a->items[j].items[j] = crealf(a->items[j].items[j]);
+        for (int i = j + 1; i < n; i++)
+            a->items[i].items[j] = conjf(a->items[j].items[i]);
+    }
+
+    double *d = malloc(n * sizeof *d);
+    double *e = malloc(n * sizeof *e);
+    Matrix *q = tridiagonal_reduce(a, d, e, vectors);
+
+    float *z = NULL;
+    if (vectors) {
+        z = calloc((size_t) n * n, sizeof *z);
+        for (int i = 0; i < n; i++)
+            z[(size_t) i * n + i] = 1.0f;
+    }
+
+    Eigen *eig = NULL;
+    if (!tridiagonal_ql(d, e, z, n)) {
+        fprintf(stderr, "matrix_hermitian_eigen: QL iterations did not converge\n");
+        errno = EDOM;
+    } else {
+        int *order = malloc(n * sizeof *order);
+        for (int i = 0; i < n; i++)
+            order[i] = i;
+        // Selection sort of the eigenvalues, which is negligible next to the reduction
+        for (int i = 0; i < n - 1; i++) {
+            int best = i;
+            for (int j = i + 1; j < n; j++)
+                if (d[order[j]] < d[order[best]])
+                    best = j;
+            int tmp = order[i];
+            order[i] = order[best];
+            order[best] = tmp;
+        }
+
+        eig = malloc(sizeof(Eigen));
+        eig->values = malloc(sizeof(Vector));
+        init_vector(eig->values, "E", n);
+        for (int i = 0; i < n; i++)
+            update_vector(eig->values, d[order[i]], i);
+
+        eig->vectors = NULL;
+        if (vectors) {
+            eig->vectors = malloc(sizeof(Matrix));
+            init_matrix(eig->vectors, "V", n, n);
+            TridiagonalVectors t = {q, z, order, eig->vectors};
+            parallel_for(0, n, COL_GRAIN, tridiagonal_eigenvectors, &t);
+        }
+        free(order);
+    }
+
+    free_matrix(a);
+    free(a);
+    if (q != NULL) {
+        free_matrix(q);
+        free(q);
+    }
+    free(z);
+    free(d);
+    free(e);
+    return eig;
+}
+
+void free_eigen(Eigen *e) {
+    assert(e != NULL);
+    free_vector(e->values);
+    free(e->values);
+    if (e->vectors != NULL) {
+        free_matrix(e->vectors);
+        free(e->vectors);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef EIGEN_HEADER
+#define EIGEN_HEADER
+
+#include "decompositions.h"
+
+// Maximum number of QR iterations spent on a single eigenvalue
+#define MAX_EIGEN_ITERATIONS 30
+
+// Eigendecomposition A = V diag(values) V^-1
+typedef struct Eigen {
+    Vector *values;
+    Matrix *vectors;    // unit eigenvectors in columns (NULL if they were not requested)
+} Eigen;
+
+// ############################### EIGENDECOMPOSITION ##################################
+
+/**
+ * @brief compute the eigenvalues (and optionally eigenvectors) of a square matrix
+ *
+ * The matrix is reduced to Hessenberg form with Householder reflectors, then to
+ * complex Schur form with single-shift implicit QR iterations (Wilkinson shifts).
+ * Eigenvectors are obtained by back substitution on the Schur form.
+ *
+ * @param m square matrix
+ * @param vectors compute the eigenvectors if true
+ * @return Eigen* the eigendecomposition, or NULL if the QR iterations did not converge
+ */
+Eigen *matrix_eigen(const Matrix *m, bool vectors);
+
+/**
+ * @brief compute the eigenvalues (and optionally eigenvectors) of a Hermitian matrix
+ *
+ * The matrix is reduced to a real symmetric tridiagonal matrix, the eigenvalues of
+ * which are found with implicit QL iterations, in O(n^2) time after the reduction.
+ * Eigenvalues are real and sorted in ascending order, eigenvectors are orthonormal.
+ *
+ * @param m Hermitian matrix (only its lower triangle is read)
+ * @param vectors compute the eigenvectors if true
+ * @return Eigen* the eigendecomposition, or NULL if the QL iterations did not converge
+ */
+Eigen *matrix_hermitian_eigen(const Matrix *m, bool vectors);
+
+/**
+ * @brief remove an eigendecomposition from memory
+ *
+ * @param e eigendecomposition
+ */
+void free_eigen(Eigen *e);
+
+#endif
@@ -0,0 +1,205 @@
+#include "expression.h"
+#include <string.h>
+
+// ############################ EXPRESSION CONSTRUCTION ################################
+
+static Expr *new_expr(ExprOp op, int rows, int cols, int depth) {
+    Expr *e = calloc(1, sizeof(Expr));
+    e->op = op;
+    e->rows = rows;
+    e->cols = cols;
+    e->depth = depth;
+    return e;
+}
+
+Expr *expr_matrix(const Matrix *m) {
+    Expr *e = new_expr(EXPR_MATRIX, m->rows, m->cols, 1);
+    e->m = m;
+    return e;
+}
+
+Expr *expr_tensor(const Tensor *t) {
+    Expr *e = new_expr(EXPR_TENSOR, t->rows, t->cols, t->depth);
+    e->t = t;
+    return e;
+}
+
+static Expr *binary_expr(ExprOp op, Expr *e, Expr *f) {
+    // Operands must have the same shape, up to the broadcast of matrices along the depth
+    assert(e->rows == f->rows && e->cols == f->cols);
+    assert(e->depth == f->depth || e->depth == 1 || f->depth == 1);
+    Expr *g = new_expr(op, e->rows, e->cols, max(e->depth, f->depth));
+    g->left = e;
+    g->right = f;
+    return g;
+}
+
+Expr *expr_add(Expr *e, Expr *f, bool add) {
+    return binary_expr(add ? EXPR_ADD : EXPR_SUB, e, f);
+}
+
+Expr *expr_scale(Expr *e, float _Complex n) {
+    Expr *g = new_expr(EXPR_SCALE, e->rows, e->cols, e->depth);
+    g->scalar = n;
+    g->left = e;
+    return g;
+}
+
+Expr *expr_hadamard(Expr *e, Expr *f) {
+    return binary_expr(EXPR_HADAMARD, e, f);
+}
+
+Expr *expr_conj(Expr *e) {
+    Expr *g = new_expr(EXPR_CONJ, e->rows, e->cols, e->depth);
+    g->left = e;
+    return g;
+}
+
+void free_expr(Expr *e) {
+    if (e == NULL)
+        return;
+    free_expr(e->left);
+    free_expr(e->right);
+    free(e);
+}
+
+// ############################ EXPRESSION EVALUATION ##################################
+
+// Expression flattened in postfix order, evaluated chunk by chunk on a stack whose
+// slot k is either an operand or buffer k
+typedef struct ExprProgram {
+    const Expr **code;
+    int length;
+    int stack;          // number of stack slots needed
+    const Expr *root;
+    Matrix *dst;        // one destination matrix per depth index
+} ExprProgram;
+
+// Append the postfix form of e to the code and return the stack size it needs
+static int compile(const Expr *e, const Expr **code, int *length) {
+    int stack = 1;
+    if (e->left != NULL)
+        stack = compile(e->left, code, length);
+    if (e->right != NULL) {
+        int right = compile(e->right, code, length) + 1;
+        stack = max(stack, right);
+    }
+    code[(*length)++] = e;
+    return stack;
+}
+
+static int count_nodes(const Expr *e) {
+    return e == NULL ? 0 : 1 + count_nodes(e->left) + count_nodes(e->right);
+}
+
+static const float _Complex *operand_chunk(const Expr *e, int d, int j, int i) {
+    const Matrix *m = e->op == EXPR_MATRIX ? e->m : e->t->items + (e->depth == 1 ? 0 : d);
+    return m->items[j].items + i;
+}
+
+// out = op(x, y) on n elements, out being allowed to alias x or y
+static void apply_operator(const Expr *e, int n, const float _Complex *x, const float _Complex *y, float _Complex *out) {
+    const float *xf = (const float *) x, *yf = (const float *) y;
+    float *of = (float *) out;
+    switch (e->op) {
+        case EXPR_ADD:
+            for (int i = 0; i < 2*n; i++)
+                of[i] = xf[i] + yf[i];
+            break;
+        case EXPR_SUB:
+            for (int i = 0; i < 2*n; i++)
+                of[i] = xf[i] - yf[i];
+            break;
+        case EXPR_SCALE: {
+            const float ar = crealf(e->scalar), ai = cimagf(e->scalar);
+            if (ai == 0.0f) {
+                for (int i = 0; i < 2*n; i++)
+                    of[i] = ar * xf[i];
+                break;
+            }
+            for (int i = 0; i < n; i++) {
+                float xr = xf[2*i], xi = xf[2*i+1];
+                of[2*i] = ar * xr - ai * xi;
+                of[2*i+1] = ar * xi + ai * xr;
+            }
+            break;
+        }
+        case EXPR_HADAMARD:
+            for (int i = 0; i < n; i++) {
+                float xr = xf[2*i], xi = xf[2*i+1];
+                float yr = yf[2*i], yi = yf[2*i+1];
+                of[2*i] = xr * yr - xi * yi;
+                of[2*i+1] = xr * yi + xi * yr;
+            }
+            break;
+        case EXPR_CONJ:
+            for (int i = 0; i < n; i++) {
+                of[2*i] = xf[2*i];
+                of[2*i+1] = -xf[2*i+1];
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Evaluate columns start to end-1, counted across all depth indices
+static void eval_columns(int start, int end, void *arg) {
+    const ExprProgram *p = arg;
+    int rows = p->root->rows, cols = p->root->cols;
+    float _Complex *buffers = malloc((size_t) p->stack * EXPR_CHUNK * sizeof *buffers);
+    const float _Complex **stack = malloc(p->stack * sizeof *stack);
+
+    for (int k = start; k < end; k++) {
+        int d = k / cols, j = k % cols;
+        for (int i = 0; i < rows; i += EXPR_CHUNK) {
+            int n = min(EXPR_CHUNK, rows - i);
+            float _Complex *dst = p->dst[d].items[j].items + i;
+            int sp = 0;
+            for (int pc = 0; pc < p->length; pc++) {
+                const Expr *e = p->code[pc];
+                if (e->op == EXPR_MATRIX || e->op == EXPR_TENSOR) {
+                    stack[sp++] = operand_chunk(e, d, j, i);
+                    continue;
+                }
+                sp -= e->right != NULL ? 2 : 1;
+                // The last operator writes straight into the destination
+                float _Complex *out = pc == p->length - 1 ? dst : buffers + (size_t) sp * EXPR_CHUNK;
+                apply_operator(e, n, stack[sp], e->right != NULL ? stack[sp+1] : NULL, out);
+                stack[sp++] = out;
+            }
+            if (stack[0] != dst)
+                memmove(dst, stack[0], n * sizeof *dst);
+        }
+    }
+    free(buffers);
+    free(stack);
+}
+
+static void eval_program(const Expr *e, Matrix *dst) {
+    ExprProgram p = {.root = e, .dst = dst};
+    p.code = malloc(count_nodes(e) * sizeof *p.code);
+    p.length = 0;
+    p.stack = compile(e, p.code, &p.length);
+    parallel_for(0, e->depth * e->cols, max(1, EXPR_CHUNK / e->rows), eval_columns, &p);
+    free(p.code);
+}
+
+void expr_eval_into(const Expr *e, Matrix *dst) {
+    assert(e->depth == 1 && dst->rows == e->rows && dst->cols == e->cols);
+    eval_program(e, dst);
+}
+
+Matrix *expr_eval_matrix(const Expr *e) {
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "M", e->rows, e->cols);
+    expr_eval_into(e, m);
+    return m;
+}
+
+Tensor *expr_eval_tensor(const Expr *e) {
+    Tensor *T = malloc(sizeof(Tensor));
+    init_tensor(T, "T", e->rows, e->cols, e->depth);
+    eval_program(e, T->items);
+    return T;
+}
@@ -0,0 +1,125 @@
+#ifndef EXPRESSION_HEADER
+#define EXPRESSION_HEADER
+
+#include "tensor.h"
+
+// Number of consecutive elements of a column pushed through an expression at once:
+// intermediate results never leave buffers of that size
+#define EXPR_CHUNK 256
+
+// Operators of an elementwise expression
+typedef enum ExprOp {
+    EXPR_MATRIX,        // matrix operand
+    EXPR_TENSOR,        // tensor operand
+    EXPR_ADD,
+    EXPR_SUB,
+    EXPR_SCALE,         // multiplication by a scalar
+    EXPR_HADAMARD,      // elementwise multiplication
+    EXPR_CONJ           // elementwise conjugate
+} ExprOp;
+
+// Node of an elementwise expression over matrices and tensors. Operators own their
+// subexpressions, operands only reference the matrix or tensor they read, which must
+// outlive the expression. A matrix operand has depth 1 and is broadcast along the
+// depth of tensor operands.
+typedef struct Expr {
+    ExprOp op;
+    int rows, cols, depth;
+    const Matrix *m;            // EXPR_MATRIX
+    const Tensor *t;            // EXPR_TENSOR
+    float _Complex scalar;      // EXPR_SCALE
+    struct Expr *left, *right;
+} Expr;
+
+// ############################ EXPRESSION CONSTRUCTION ################################
+
+/**
+ * @brief create an expression reading a matrix
+ *
+ * @param m matrix
+ * @return Expr* operand node
+ */
+Expr *expr_matrix(const Matrix *m);
+
+/**
+ * @brief create an expression reading a tensor
+ *
+ * @param t tensor
+ * @return Expr* operand node
+ */
+Expr *expr_tensor(const Tensor *t);
+
+/**
+ * @brief create the expression e + f (or e - f), taking ownership of both operands
+ *
+ * @param e first operand
+ * @param f second operand
+ * @param add boolean to indicate addition
+ * @return Expr* addition if add is true, otherwise subtraction
+ */
+Expr *expr_add(Expr *e, Expr *f, bool add);
+
+/**
+ * @brief create the expression n * e, taking ownership of e
+ *
+ * @param e operand
+ * @param n scalar value
+ * @return Expr* scaled expression
+ */
+Expr *expr_scale(Expr *e, float _Complex n);
+
+/**
+ * @brief create the elementwise product of two expressions, taking ownership of both
+ *
+ * @param e first operand
+ * @param f second operand
+ * @return Expr* Hadamard product
+ */
+Expr *expr_hadamard(Expr *e, Expr *f);
+
+/**
+ * @brief create the elementwise conjugate of an expression, taking ownership of it
+ *
+ * @param e operand
+ * @return Expr* conjugated expression
+ */
+Expr *expr_conj(Expr *e);
+
+/**
+ * @brief remove an expression and all its subexpressions from memory
+ *
+ * @param e expression
+ */
+void free_expr(Expr *e);
+
+// ############################ EXPRESSION EVALUATION ##################################
+
+/**
+ * @brief evaluate an expression of depth 1 into an existing matrix
+ *
+ * The whole expression is evaluated in one pass over its operands, chunk by chunk,
+ * columns being processed in parallel. dst may be a view, and may be one of the
+ * operands since every element is read before it is overwritten.
+ *
+ * @param e expression
+ * @param dst matrix of the shape of the expression
+ */
+void expr_eval_into(const Expr *e, Matrix *dst);
+
+/**
+ * @brief evaluate an expression of depth 1
+ *
+ * @param e expression
+ * @return Matrix* result
+ */
+Matrix *expr_eval_matrix(const Expr *e);
+
+/**
+ * @brief evaluate an expression into a tensor, in a single pass over its operands
+ *
+ * @param e expression
+ * @return Tensor* result
+ */
+Tensor *expr_eval_tensor(const Expr *e);
+
+#endif
@@ -0,0 +1,202 @@
+#include "half.h"
+#include "kernels.h"
+
+// ############################## CONVERSION KERNELS ###################################
+
+void floats_to_halves(size_t n, const float *x, uint16_t *h, HalfFormat format) {
+    for (size_t i = 0; i < n; i++)
+        h[i] = float_to_half(x[i], format);
+}
+
+void halves_to_floats(size_t n, const uint16_t *h, float *x, HalfFormat format) {
+    for (size_t i = 0; i < n; i++)
+        x[i] = half_to_float(h[i], format);
+}
+
+// ########################### HALF-PRECISION CONSTRUCTION #############################
+
+int init_half_vector(HalfVector *v, const char *name, int rows, HalfFormat format) {
+    if (rows <= 0) {
+        fprintf(stderr, "init_half_vector: bad size %d\n", rows);
+        errno = EINVAL;
+        return VECTOR_ERR_BAD_SIZE;
+    }
+
+    v->name = strdup(name);
+    if (!v->name) {
+        perror("strdup failed");
+        errno = ENOMEM;
+        return VECTOR_ERR_OOM;
+    }
+
+    v->capacity = rows;
+    v->format = format;
+    // Zero is all bits clear in both formats
+    v->items = calloc(2 * (size_t) rows, sizeof *v->items);
+    if (v->items == NULL) {
+        perror("calloc failed");
+        free(v->name);
+        errno = ENOMEM;
+        return VECTOR_ERR_OOM;
+    }
+    return VECTOR_SUCCESS;
+}
+
+void free_half_vector(HalfVector *v) {
+    free(v->items);
+    free(v->name);
+}
+
+void init_half_matrix(HalfMatrix *m, char *name, int rows, int cols, HalfFormat format) {
+    assert(rows > 0 && cols > 0);
+
+    m->rows = rows;
+    m->cols = cols;
+    m->format = format;
+    m->name = name;
+    m->items = malloc(cols * sizeof(HalfVector));
+
+    for (int i = 0; i < cols; i++)
+        init_half_vector(m->items+i, "V", rows, format);
+}
+
+void free_half_matrix(HalfMatrix *m) {
+    assert(m != NULL);
+    for (int i = 0; i < m->cols; i++)
+        free_half_vector(m->items+i);
+    free(m->items);
+}
+
+HalfVector *half_vector_from_vector(const Vector *v, HalfFormat format) {
+    HalfVector *h = malloc(sizeof(HalfVector));
+    init_half_vector(h, "V", v->capacity, format);
+    floats_to_halves(2 * (size_t) v->capacity, (const float *) v->items, h->items, format);
+    return h;
+}
+
+Vector *vector_from_half_vector(const HalfVector *v) {
+    Vector *w = malloc(sizeof(Vector));
+    init_vector(w, "V", v->capacity);
+    halves_to_floats(2 * (size_t) v->capacity, v->items, (float *) w->items, v->format);
+    return w;
+}
+
+// Half-precision matrix and the matrix of floats it is converted from or to
+typedef struct HalfBlock {
+    const HalfMatrix *h;
+    Matrix *m;
+} HalfBlock;
+
+static void encode_columns(int start, int end, void *arg) {
+    const HalfBlock *b = arg;
+    for (int j = start; j < end; j++)
+        floats_to_halves(2 * (size_t) b->m->rows, (const float *) b->m->items[j].items, b->h->items[j].items, b->h->format);
+}
+
+static void decode_columns(int start, int end, void *arg) {
+    const HalfBlock *b = arg;
+    for (int j = start; j < end; j++)
+        halves_to_floats(2 * (size_t) b->m->rows, b->h->items[j].items, (float *) b->m->items[j].items, b->h->format);
+}
+
+HalfMatrix *half_matrix_from_matrix(const Matrix *m, HalfFormat format) {
+    HalfMatrix *h = malloc(sizeof(HalfMatrix));
+    init_half_matrix(h, "M", m->rows, m->cols, format);
+    HalfBlock b = {h, (Matrix *) m};
+    parallel_for(0, m->cols, max(1, GEMV_ROW_BLOCK / m->rows), encode_columns, &b);
+    return h;
+}
+
+Matrix *matrix_from_half_matrix(const HalfMatrix *m) {
+    Matrix *w = malloc(sizeof(Matrix));
+    init_matrix(w, "M", m->rows, m->cols);
+    HalfBlock b = {m, w};
+    parallel_for(0, m->cols, max(1, GEMV_ROW_BLOCK / m->rows), decode_columns, &b);
+    return w;
+}
+
+// ########################### HALF-PRECISION OPERATIONS ###############################
+
+float _Complex half_vector_inner_product(const HalfVector *u, const HalfVector *v) {
+    assert(u->capacity == v->capacity);
+    float real_result = 0.0f, imag_result = 0.0f;
+    for (int i = 0; i < u->capacity; i++) {
+        float a = half_to_float(u->items[2*i], u->format);
+        float b = half_to_float(u->items[2*i+1], u->format);
+        float c = half_to_float(v->items[2*i], v->format);
+        float d = half_to_float(v->items[2*i+1], v->format);
+        real_result += a * c + b * d;
+        imag_result += b * c - a * d;
+    }
+    return real_result + imag_result * I;
+}
+
+typedef struct HalfGemv {
+    float _Complex alpha;
+    const HalfMatrix *a;
+    const float _Complex *x;
+    float _Complex beta;
+    float _Complex *y;
+} HalfGemv;
+
+// y[start:end] = alpha A[start:end, :] x + beta y[start:end], each column segment of A
+// being decoded to a small buffer before its update
+static void half_gemv_rows(int start, int end, void *arg) {
+    const HalfGemv *g = arg;
+    int rows = end - start;
+    float _Complex *column = malloc(rows * sizeof *column);
+    if (g->beta == 0.0f)
+        memset(g->y + start, 0, rows * sizeof *g->y);
+    else if (g->beta != 1.0f)
+        complex_scal(rows, g->beta, g->y + start);
+    for (int j = 0; j < g->a->cols; j++) {
+        float _Complex xj = g->alpha * g->x[j];
+        if (xj == 0.0f)
+            continue;
+        halves_to_floats(2 * (size_t) rows, g->a->items[j].items + 2 * (size_t) start, (float *) column, g->a->format);
+        complex_axpy(rows, xj, column, g->y + start);
+    }
+    free(column);
+}
+
+Vector *half_matrix_gemv(float _Complex alpha, const HalfMatrix *a, const Vector *x, float _Complex beta, Vector *y) {
+    assert(x->capacity == a->cols);
+    if (y == NULL) {
+        y = malloc(sizeof(Vector));
+        init_vector(y, "V", a->rows);
+        beta = 0.0f;
+    }
+    assert(y->capacity == a->rows);
+    HalfGemv g = {alpha, a, x->items, beta, y->items};
+    parallel_for(0, a->rows, HALF_GEMV_ROW_BLOCK, half_gemv_rows, &g);
+    return y;
+}
+
+// pack_func of a HalfMatrix: decode the real parts of the block to r if all its
+// imaginary parts are +/-0, and the whole block to p otherwise
+static bool pack_half(const void *x, int i0, int rows, int j0, int cols, float _Complex *p, float *r) {
+    const HalfMatrix *h = x;
+    bool nonreal = false;
+    for (int j = 0; j < cols && !nonreal; j++) {
+        const uint16_t *col = h->items[j0 + j].items + 2 * (size_t) i0;
+        for (int i = 0; i < rows; i++)
+            nonreal |= (col[2*i+1] & 0x7fff) != 0;
+    }
+    for (int j = 0; j < cols; j++) {
+        const uint16_t *col = h->items[j0 + j].items + 2 * (size_t) i0;
+        if (nonreal) {
+            halves_to_floats(2 * (size_t) rows, col, (float *) (p + (size_t) j * rows), h->format);
+            continue;
+        }
+        float *dst = r + (size_t) j * rows;
+        for (int i = 0; i < rows; i++)
+            dst[i] = half_to_float(col[2*i], h->format);
+    }
+    return !nonreal;
+}
+
+Matrix *half_matrix_gemm(float _Complex alpha, const HalfMatrix *a, const HalfMatrix *b, float _Complex beta, Matrix *c) {
+    GemmOperand ga = {a->rows, a->cols, pack_half, a};
+    GemmOperand gb = {b->rows, b->cols, pack_half, b};
+    return matrix_gemm_packed(alpha, ga, gb, beta, c);
+}
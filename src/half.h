@@ -0,0 +1,243 @@
+#ifndef HALF_HEADER
+#define HALF_HEADER
+
+#include "matrix.h"
+#include <stdint.h>
+#include <string.h>
+
+// 16-bit storage formats for real numbers. IEEE fp16 keeps 11 significant bits over
+// magnitudes from 6e-8 to 65504, bfloat16 keeps the range of float with 8 significant
+// bits. Either halves the memory and the traffic of float _Complex elements; all the
+// arithmetic is done in float.
+typedef enum HalfFormat {
+    HALF_FP16,
+    HALF_BF16
+} HalfFormat;
+
+// Vector of complex numbers, stored as interleaved real and imaginary halves
+typedef struct HalfVector {
+    int capacity;
+    HalfFormat format;
+    uint16_t *items;    // 2 * capacity halves
+    char *name;
+} HalfVector;
+
+// Matrix of complex numbers stored by columns, as the Matrix type
+typedef struct HalfMatrix {
+    int rows;
+    int cols;
+    HalfFormat format;
+    HalfVector *items;
+    char *name;
+} HalfMatrix;
+
+// Number of rows of a half-precision matrix decoded at once by its GEMV
+#define HALF_GEMV_ROW_BLOCK 512
+
+// ############################## CONVERSION KERNELS ###################################
+
+static inline uint32_t float_bits(float x) {
+    uint32_t u;
+    memcpy(&u, &x, sizeof u);
+    return u;
+}
+
+static inline float bits_float(uint32_t u) {
+    float x;
+    memcpy(&x, &u, sizeof x);
+    return x;
+}
+
+/**
+ * @brief round a float to the nearest half, ties to even
+ *
+ * Values beyond the range of fp16 become infinite, NaNs stay NaNs.
+ *
+ * @param x float
+ * @param format storage format
+ * @return uint16_t bits of the half
+ */
+static inline uint16_t float_to_half(float x, HalfFormat format) {
+    uint32_t u = float_bits(x);
+    if (format == HALF_BF16) {
+        if ((u & 0x7fffffffu) > 0x7f800000u)
+            return (u >> 16) | 0x40;
+        return (u + 0x7fffu + ((u >> 16) & 1)) >> 16;
+    }
+    uint32_t sign = (u >> 16) & 0x8000u;
+    u &= 0x7fffffffu;
+    uint16_t h;
+    if (u >= (127u + 16) << 23) {
+        // Overflow, infinity or NaN
+        h = u > 0x7f800000u ? 0x7e00 : 0x7c00;
+    } else if (u < 113u << 23) {
+        // Subnormal half: adding 0.5 aligns the 10 bits of mantissa at the bottom of
+        // the float, the addition doing the rounding
+        const uint32_t magic = ((127u - 15) + (23 - 10) + 1) << 23;
+        h = float_bits(bits_float(u) + bits_float(magic)) - magic;
+    } else {
+        // Rebias the exponent, rounding the 13 dropped bits to nearest even
+        u += ((uint32_t) (15 - 127) << 23) + 0xfffu + ((u >> 13) & 1);
+        h = u >> 13;
+    }
+    return h | sign;
+}
+
+/**
+ * @brief return the float holding the value of a half exactly
+ *
+ * @param h bits of the half
+ * @param format storage format
+ * @return float value
+ */
+static inline float half_to_float(uint16_t h, HalfFormat format) {
+    if (format == HALF_BF16)
+        return bits_float((uint32_t) h << 16);
+    uint32_t u = (uint32_t) (h & 0x7fff) << 13;
+    uint32_t exponent = u & (0x7c00u << 13);
+    u += (127u - 15) << 23;
+    if (exponent == 0x7c00u << 13) {
+        // Infinity or NaN
+        u += (128u - 16) << 23;
+    } else if (exponent == 0) {
+        // Zero or subnormal, renormalised by a float subtraction
+        u = float_bits(bits_float(u + (1u << 23)) - bits_float(113u << 23));
+    }
+    return bits_float(u | (uint32_t) (h & 0x8000) << 16);
+}
+
+/**
+ * @brief round n floats to halves
+ *
+ * @param n number of floats
+ * @param x floats
+ * @param h halves to overwrite
+ * @param format storage format
+ */
+void floats_to_halves(size_t n, const float *x, uint16_t *h, HalfFormat format);
+
+/**
+ * @brief widen n halves to floats
+ *
+ * @param n number of halves
+ * @param h halves
+ * @param x floats to overwrite
+ * @param format storage format
+ */
+void halves_to_floats(size_t n, const uint16_t *h, float *x, HalfFormat format);
+
+// ########################### HALF-PRECISION CONSTRUCTION #############################
+
+/**
+ * @brief initialise a half-precision vector of zeroes
+ *
+ * @param v vector to initialise
+ * @param name vector id
+ * @param rows number of rows the vector will have
+ * @param format storage format
+ * @return int status of the initialization (0 for success, negative int for failure)
+ */
+int init_half_vector(HalfVector *v, const char *name, int rows, HalfFormat format);
+
+/**
+ * @brief remove a half-precision vector from memory
+ *
+ * @param v vector to be removed
+ */
+void free_half_vector(HalfVector *v);
+
+/**
+ * @brief initialise a half-precision matrix of zeroes
+ *
+ * @param m matrix to initialise
+ * @param name matrix id
+ * @param rows number of rows
+ * @param cols number of columns
+ * @param format storage format
+ */
+void init_half_matrix(HalfMatrix *m, char *name, int rows, int cols, HalfFormat format);
+
+/**
+ * @brief remove a half-precision matrix from memory
+ *
+ * @param m matrix to be removed
+ */
+void free_half_matrix(HalfMatrix *m);
+
+/**
+ * @brief round a vector to half precision
+ *
+ * @param v vector
+ * @param format storage format
+ * @return HalfVector* rounded copy of v
+ */
+HalfVector *half_vector_from_vector(const Vector *v, HalfFormat format);
+
+/**
+ * @brief widen a half-precision vector
+ *
+ * @param v half-precision vector
+ * @return Vector* copy of v
+ */
+Vector *vector_from_half_vector(const HalfVector *v);
+
+/**
+ * @brief round a matrix to half precision, column by column in parallel
+ *
+ * @param m matrix
+ * @param format storage format
+ * @return HalfMatrix* rounded copy of m
+ */
+HalfMatrix *half_matrix_from_matrix(const Matrix *m, HalfFormat format);
+
+/**
+ * @brief widen a half-precision matrix, column by column in parallel
+ *
+ * @param m half-precision matrix
+ * @return Matrix* copy of m
+ */
+Matrix *matrix_from_half_matrix(const HalfMatrix *m);
+
+// ########################### HALF-PRECISION OPERATIONS ###############################
+
+/**
+ * @brief return the inner product sum u_i conj(v_i), accumulated in float
+ *
+ * @param u first vector
+ * @param v second vector, of the same size
+ * @return float _Complex inner product
+ */
+float _Complex half_vector_inner_product(const HalfVector *u, const HalfVector *v);
+
+/**
+ * @brief compute y = alpha A x + beta y for a half-precision A
+ *
+ * A is read once, HALF_GEMV_ROW_BLOCK rows at a time being decoded to float and
+ * accumulated in float; blocks of rows are computed in parallel.
+ *
+ * @param alpha scalar multiplying the product
+ * @param a half-precision matrix
+ * @param x vector with as many rows as a has columns
+ * @param beta scalar multiplying y (ignored if y is NULL)
+ * @param y vector to update, or NULL to return a new vector
+ * @return Vector* the updated or new vector y
+ */
+Vector *half_matrix_gemv(float _Complex alpha, const HalfMatrix *a, const Vector *x, float _Complex beta, Vector *y);
+
+/**
+ * @brief compute C = alpha A B + beta C for half-precision A and B
+ *
+ * Blocks of A and B are decoded to float straight into the packed buffers of
+ * matrix_gemm_packed, so that no more than a block of each is ever held as floats and
+ * the products are accumulated in float.
+ *
+ * @param alpha scalar multiplying the product
+ * @param a left operand
+ * @param b right operand
+ * @param beta scalar multiplying c (ignored if c is NULL)
+ * @param c matrix to update, or NULL to return a new matrix
+ * @return Matrix* the updated or new matrix C
+ */
+Matrix *half_matrix_gemm(float _Complex alpha, const HalfMatrix *a, const HalfMatrix *b, float _Complex beta, Matrix *c);
+
+#endif
@@ -1,5 +1,8 @@
 #include "helpers.h"
 
+// Weyl increment of the state of splitmix64
+#define SPLITMIX64_GAMMA 0x9e3779b97f4a7c15ull
+
 /**
  * @brief helper to convert radians to degrees
  * 
@@ -8,4 +11,59 @@
  */
 float radians_to_degrees(float radians) {
     return (float) 180 * fmod(radians, 2*M_PI) / M_PI;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief map two uniforms to a standard gaussian with the Box-Muller transform
+ * 
+ * @param u1 uniform in (0, 1]
+ * @param u2 uniform in [0, 1]
+ * @return float standard gaussian
+ */
+float box_muller(float u1, float u2) {
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * M_PI * u2);
+}
+
+/**
+ * @brief advance a splitmix64 generator and return its next output
+ * 
+ * The k-th output only depends on the initial state plus k increments, so a stream
+ * can be started at any draw in constant time (see random_stream).
+ * 
+ * @param state state of the generator
+ * @return uint64_t 64 random bits
+ */
+uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += SPLITMIX64_GAMMA);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief draw the base seed of a random matrix or vector from rand()
+ * 
+ * @return uint64_t seed, reproducible through srand()
+ */
+uint64_t random_seed(void) {
+    uint64_t seed = rand();
+    seed = seed << 31 | rand();
+    return seed << 31 | rand();
+}
+
+/**
+ * @brief state of the stream of a block of a random matrix or vector, positioned
+ * so that the next call to splitmix64 returns its draw number offset
+ * 
+ * Every block has its own stream, started from the hash of seed + block, so that
+ * blocks can be filled in any order, by any thread, with the same result.
+ * 
+ * @param seed base seed
+ * @param block index of the block
+ * @param offset number of draws of the stream to skip
+ * @return uint64_t state of the generator
+ */
+uint64_t random_stream(uint64_t seed, uint64_t block, uint64_t offset) {
+    uint64_t state = seed + block;
+    return splitmix64(&state) + offset * SPLITMIX64_GAMMA;
+}
@@ -2,9 +2,14 @@
 #define HELPERS_HEADER
 
 #include "libs.h"
+#include <stdint.h>
 
 // Helper functions
 float radians_to_degrees(float radians);
 float complex_abs(float _Complex z);
+float box_muller(float u1, float u2);
+uint64_t splitmix64(uint64_t *state);
+uint64_t random_seed(void);
+uint64_t random_stream(uint64_t seed, uint64_t block, uint64_t offset);
 
 #endif
\ No newline at end of file
@@ -11,5 +11,6 @@
 #include <assert.h>
 
 #define max(X,Y) ((X > Y) ? X : Y)
+#define min(X,Y) ((X < Y) ? X : Y)
 
 #endif
\ No newline at end of file
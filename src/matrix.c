@@ -1,9 +1,36 @@
 #include "matrix.h"
+#include "decompositions.h"
+#include "eigen.h"
+#include "expression.h"
+#include "kernels.h"
+#include "numa.h"
+#ifdef __AVX__
+    #include <immintrin.h>
+#endif
 
-void *thread_func(void *arg) {
-    const Matrix *m1 = ((Matrix **)arg)[0];
-    const Matrix *m2 = ((Matrix **)arg)[1];
-    return (void *)fast_matrix_mult(m1, m2);
+// Operands and result of one of the seven Strassen products
+typedef struct StrassenProduct {
+    const Matrix *a;
+    const Matrix *b;
+    Matrix *result;
+} StrassenProduct;
+
+static void strassen_product_task(void *arg) {
+    StrassenProduct *p = arg;
+    p->result = fast_matrix_mult(p->a, p->b);
+}
+
+static void free_matrices(Matrix **ms, int count) {
+    for (int i = 0; i < count; i++) {
+        free_matrix(ms[i]);
+        free(ms[i]);
+    }
+}
+
+static void zero_columns(int start, int end, void *arg) {
+    Matrix *m = arg;
+    for (int j = start; j < end; j++)
+        zero_fill(m->items[j].items, m->rows, sizeof *m->items[j].items);
 }
 
 void init_matrix(Matrix *m, char *name, int rows, int cols) {
@@ -15,7 +42,13 @@ void init_matrix(Matrix *m, char *name, int rows, int cols) {
     m->items = malloc(cols * sizeof(Vector));
     
     for (int i = 0; i < cols; i++)
-        init_vector(m->items+i, "V", rows);
+        init_vector_unfilled(m->items+i, "V", rows);
+    // Columns are first written by the tasks of the column blocks of the GEMM, which
+    // places their pages on the nodes of the workers computing them
+    if (get_alloc_policy() == ALLOC_LOCAL)
+        zero_columns(0, cols, m);
+    else
+        parallel_for(0, cols, GEMM_NC, zero_columns, m);
 }
 
 void free_matrix(Matrix *m) {
@@ -33,13 +66,77 @@ void update_matrix(Matrix *m, float _Complex n, int row, int col) {
     m->items[col].items[row] = n;
 }
 
+Matrix *matrix_copy(const Matrix *m) {
+    Matrix *c = malloc(sizeof(Matrix));
+    init_matrix(c, m->name, m->rows, m->cols);
+    for (int j = 0; j < m->cols; j++)
+        memcpy(c->items[j].items, m->items[j].items, m->rows * sizeof *m->items[j].items);
+    return c;
+}
+
+// Matrix filled by blocks of GEMM_NC columns, each from its own random stream
+typedef struct RandomFill {
+    Matrix *m;
+    uint64_t seed;
+} RandomFill;
+
+// Stream of column j, positioned after the draws of the previous columns of its block
+static uint64_t column_stream(uint64_t seed, int j, uint64_t draws) {
+    return random_stream(seed, j / GEMM_NC, (uint64_t) (j % GEMM_NC) * draws);
+}
+
+static void rademacher_columns(int start, int end, void *arg) {
+    const RandomFill *r = arg;
+    int rows = r->m->rows;
+    for (int j = start; j < end; j++) {
+        // One bit per element
+        uint64_t state = column_stream(r->seed, j, (rows + 63) / 64), bits = 0;
+        float _Complex *col = r->m->items[j].items;
+        for (int i = 0; i < rows; i++) {
+            if (i % 64 == 0)
+                bits = splitmix64(&state);
+            col[i] = (bits >> (i % 64) & 1) ? 1.0f : -1.0f;
+        }
+    }
+}
+
+static void gaussian_columns(int start, int end, void *arg) {
+    const RandomFill *r = arg;
+    int rows = r->m->rows;
+    for (int j = start; j < end; j++) {
+        uint64_t state = column_stream(r->seed, j, rows);
+        float _Complex *col = r->m->items[j].items;
+        for (int i = 0; i < rows; i++) {
+            // Two 24-bit uniforms in (0, 1], so that the logarithm stays finite
+            uint64_t bits = splitmix64(&state);
+            float u1 = ((bits >> 40) + 1) * 0x1p-24f;
+            float u2 = ((bits >> 16 & 0xffffff) + 1) * 0x1p-24f;
+            col[i] = box_muller(u1, u2);
+        }
+    }
+}
+
 Matrix *rademacher_matrix(int rows, int cols) {
     Matrix *m = malloc(sizeof(Matrix));
     init_matrix(m, "M", rows, cols);
+    RandomFill r = {m, random_seed()};
+    parallel_for(0, cols, GEMM_NC, rademacher_columns, &r);
+    return m;
+}
+
+Matrix *gaussian_matrix(int rows, int cols) {
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "G", rows, cols);
+    RandomFill r = {m, random_seed()};
+    parallel_for(0, cols, GEMM_NC, gaussian_columns, &r);
+    return m;
+}
 
-    for (int i = 0; i < rows; i++)
-        for (int j = 0; j < cols; j++)
-            update_matrix(m, (rand() % 2) ? 1.0f + 0.0f * I : -1.0f + 0.0f * I, i, j);
+Matrix *identity_matrix(int n) {
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "I", n, n);
+    for (int i = 0; i < n; i++)
+        update_matrix(m, 1.0f, i, i);
     return m;
 }
 
@@ -71,32 +168,520 @@ Matrix *matrix_scalar_mult(float _Complex n, const Matrix *m) {
 Matrix *matrix_mult(const Matrix *m1, const Matrix *m2) {
     // Inner dimensions must be the same
     assert(m1->cols == m2->rows);
-    
-    Matrix *m = malloc(sizeof(Matrix));
-    init_matrix(m, "M", m1->rows, m2->cols); // keep outer dimensions
-    
-    // Perform standard matrix multiplication algorithm
-    for (int i = 0; i < m1->rows; i++)
-        for (int j = 0; j < m2->cols; j++)
-            for (int k = 0; k < m2->rows; k++)
-                // We do not use update_matrix() since we must increase the existing value instead of replacing it
-                m->items[j].items[i] += m1->items[k].items[i] * m2->items[j].items[k];
-    return m;
+    return matrix_gemm(1.0f, view_of(m1), view_of(m2), 0.0f, NULL);
+}
+
+static inline int view_rows(MatrixView v) {
+    return v.trans ? v.m->cols : v.m->rows;
+}
+
+static inline int view_cols(MatrixView v) {
+    return v.trans ? v.m->rows : v.m->cols;
+}
+
+// pack_func of a MatrixView: copy the block of op(v) to p, keeping only its real parts
+// in r if it has no imaginary part
+static bool pack_view(const void *x, int i0, int rows, int j0, int cols, float _Complex *p, float *r) {
+    const MatrixView *v = x;
+    bool nonreal = false;
+    for (int j = 0; j < cols; j++) {
+        float _Complex *dst = p + (size_t) j * rows;
+        if (!v->trans) {
+            memcpy(dst, v->m->items[j0 + j].items + i0, rows * sizeof *dst);
+        } else {
+            for (int i = 0; i < rows; i++)
+                dst[i] = v->m->items[i0 + i].items[j0 + j];
+        }
+        if (v->conj) {
+            for (int i = 0; i < rows; i++)
+                dst[i] = conjf(dst[i]);
+        }
+        const float *f = (const float *) dst;
+        for (int i = 0; i < rows; i++)
+            nonreal |= f[2*i+1] != 0.0f;
+    }
+    if (nonreal)
+        return false;
+    const float *f = (const float *) p;
+    for (size_t i = 0; i < (size_t) rows * cols; i++)
+        r[i] = f[2*i];
+    return true;
+}
+
+GemmOperand view_operand(const MatrixView *v) {
+    return (GemmOperand) {view_rows(*v), view_cols(*v), pack_view, v};
+}
+
+// p = alpha r on n elements
+static void widen_real(size_t n, const float *r, float _Complex alpha, float _Complex *p) {
+    float *f = (float *) p;
+    const float ar = crealf(alpha), ai = cimagf(alpha);
+    for (size_t i = 0; i < n; i++) {
+        f[2*i] = ar * r[i];
+        f[2*i+1] = ai * r[i];
+    }
+}
+
+// c[q] += ap bp[:, q] for q < 4, with ap a packed mc x kc panel and bp kc x 4: the
+// four columns of C are updated in a single pass over each column of ap
+static void gemm_kernel_4(int mc, int kc, const float _Complex *ap, const float _Complex *bp, float _Complex *const c[4]) {
+    float *restrict c0 = (float *) c[0], *restrict c1 = (float *) c[1];
+    float *restrict c2 = (float *) c[2], *restrict c3 = (float *) c[3];
+    for (int k = 0; k < kc; k++) {
+        const float *a = (const float *) (ap + (size_t) k * mc);
+        float b0r = crealf(bp[k]), b0i = cimagf(bp[k]);
+        float b1r = crealf(bp[kc + k]), b1i = cimagf(bp[kc + k]);
+        float b2r = crealf(bp[2 * kc + k]), b2i = cimagf(bp[2 * kc + k]);
+        float b3r = crealf(bp[3 * kc + k]), b3i = cimagf(bp[3 * kc + k]);
+        for (int i = 0; i < mc; i++) {
+            float ar = a[2*i], ai = a[2*i+1];
+            c0[2*i] += b0r * ar - b0i * ai;
+            c0[2*i+1] += b0r * ai + b0i * ar;
+            c1[2*i] += b1r * ar - b1i * ai;
+            c1[2*i+1] += b1r * ai + b1i * ar;
+            c2[2*i] += b2r * ar - b2i * ai;
+            c2[2*i+1] += b2r * ai + b2i * ar;
+            c3[2*i] += b3r * ar - b3i * ai;
+            c3[2*i+1] += b3r * ai + b3i * ar;
+        }
+    }
+}
+
+// Same as gemm_kernel_4 for a real panel of B: every element of C takes 2 multiplications
+// instead of 4
+static void gemm_kernel_4_real_b(int mc, int kc, const float _Complex *ap, const float *bp, float _Complex *const c[4]) {
+    float *restrict c0 = (float *) c[0], *restrict c1 = (float *) c[1];
+    float *restrict c2 = (float *) c[2], *restrict c3 = (float *) c[3];
+    for (int k = 0; k < kc; k++) {
+        const float *a = (const float *) (ap + (size_t) k * mc);
+        float b0 = bp[k], b1 = bp[kc + k], b2 = bp[2 * kc + k], b3 = bp[3 * kc + k];
+        for (int i = 0; i < 2*mc; i++) {
+            c0[i] += b0 * a[i];
+            c1[i] += b1 * a[i];
+            c2[i] += b2 * a[i];
+            c3[i] += b3 * a[i];
+        }
+    }
+}
+
+// Same as gemm_kernel_4 for a real panel of A
+static void gemm_kernel_4_real_a(int mc, int kc, const float *ap, const float _Complex *bp, float _Complex *const c[4]) {
+    float *restrict c0 = (float *) c[0], *restrict c1 = (float *) c[1];
+    float *restrict c2 = (float *) c[2], *restrict c3 = (float *) c[3];
+    for (int k = 0; k < kc; k++) {
+        const float *a = ap + (size_t) k * mc;
+        float b0r = crealf(bp[k]), b0i = cimagf(bp[k]);
+        float b1r = crealf(bp[kc + k]), b1i = cimagf(bp[kc + k]);
+        float b2r = crealf(bp[2 * kc + k]), b2i = cimagf(bp[2 * kc + k]);
+        float b3r = crealf(bp[3 * kc + k]), b3i = cimagf(bp[3 * kc + k]);
+        for (int i = 0; i < mc; i++) {
+            c0[2*i] += b0r * a[i];
+            c0[2*i+1] += b0i * a[i];
+            c1[2*i] += b1r * a[i];
+            c1[2*i+1] += b1i * a[i];
+            c2[2*i] += b2r * a[i];
+            c2[2*i+1] += b2i * a[i];
+            c3[2*i] += b3r * a[i];
+            c3[2*i+1] += b3i * a[i];
+        }
+    }
+}
+
+// c[:, q] = ap bp[:, q] for q < cols <= 4 with real panels, c being a contiguous mc x 4
+// real block: a quarter of the multiplications and half the panel bandwidth
+static void gemm_kernel_real(int mc, int kc, int cols, const float *ap, const float *bp, float *restrict c) {
+    memset(c, 0, (size_t) 4 * mc * sizeof *c);
+    if (cols < 4) {
+        for (int q = 0; q < cols; q++)
+            for (int k = 0; k < kc; k++) {
+                const float *a = ap + (size_t) k * mc;
+                float b = bp[(size_t) q * kc + k];
+                for (int i = 0; i < mc; i++)
+                    c[(size_t) q * mc + i] += b * a[i];
+            }
+        return;
+    }
+    float *c0 = c, *c1 = c + mc, *c2 = c + 2 * mc, *c3 = c + 3 * mc;
+    const float *b0 = bp, *b1 = bp + kc, *b2 = bp + 2 * kc, *b3 = bp + 3 * kc;
+    int k = 0;
+    // Four steps of k per pass, so that C is loaded and stored once for 16 products
+    for (; k + 4 <= kc; k += 4) {
+        const float *a0 = ap + (size_t) k * mc, *a1 = a0 + mc, *a2 = a1 + mc, *a3 = a2 + mc;
+        for (int i = 0; i < mc; i++) {
+            c0[i] += b0[k] * a0[i] + b0[k+1] * a1[i] + b0[k+2] * a2[i] + b0[k+3] * a3[i];
+            c1[i] += b1[k] * a0[i] + b1[k+1] * a1[i] + b1[k+2] * a2[i] + b1[k+3] * a3[i];
+            c2[i] += b2[k] * a0[i] + b2[k+1] * a1[i] + b2[k+2] * a2[i] + b2[k+3] * a3[i];
+            c3[i] += b3[k] * a0[i] + b3[k+1] * a1[i] + b3[k+2] * a2[i] + b3[k+3] * a3[i];
+        }
+    }
+    for (; k < kc; k++) {
+        const float *a = ap + (size_t) k * mc;
+        for (int i = 0; i < mc; i++) {
+            c0[i] += b0[k] * a[i];
+            c1[i] += b1[k] * a[i];
+            c2[i] += b2[k] * a[i];
+            c3[i] += b3[k] * a[i];
+        }
+    }
+}
+
+typedef struct Gemm Gemm;
+
+// Computes the block C[i_start:i_end, start:end] of a product
+typedef void (*gemm_block_func)(const Gemm *g, int i_start, int i_end, int start, int end);
+
+// A product split into tiles of GEMM_NC columns of C by row_step rows, row_step being
+// a multiple of GEMM_MC
+struct Gemm {
+    float _Complex alpha;
+    GemmOperand a;
+    GemmOperand b;
+    float _Complex beta;
+    Matrix *c;
+    gemm_block_func block;
+    int row_step;
+    int row_tiles;
+};
+
+// C[i_start:i_end, start:end] *= beta
+static void scale_block(const Gemm *g, int i_start, int i_end, int start, int end) {
+    for (int j = start; j < end; j++) {
+        float _Complex *c = g->c->items[j].items + i_start;
+        if (g->beta == 0.0f)
+            memset(c, 0, (i_end - i_start) * sizeof *c);
+        else if (g->beta != 1.0f)
+            complex_scal(i_end - i_start, g->beta, c);
+    }
+}
+
+// Pack a block of B scaled by alpha, which stays real only if alpha is
+static bool pack_scaled(const Gemm *g, int k0, int kc, int j0, int n, float _Complex *bp, float *bpr) {
+    size_t len = (size_t) kc * n;
+    if (g->b.pack(g->b.x, k0, kc, j0, n, bp, bpr)) {
+        if (cimagf(g->alpha) == 0.0f) {
+            for (size_t i = 0; g->alpha != 1.0f && i < len; i++)
+                bpr[i] *= crealf(g->alpha);
+            return true;
+        }
+        widen_real(len, bpr, g->alpha, bp);
+    } else if (g->alpha != 1.0f) {
+        complex_scal(len, g->alpha, bp);
+    }
+    return false;
+}
+
+static void gemm_block(const Gemm *g, int i_start, int i_end, int start, int end) {
+    int n = end - start, k = g->a.cols;
+    size_t kmax = min(GEMM_KC, k);
+    float _Complex *ap = malloc(GEMM_MC * kmax * sizeof *ap);
+    float _Complex *bp = malloc(kmax * n * sizeof *bp);
+    // Real panels, used when the packed blocks have no imaginary part
+    float *apr = malloc(GEMM_MC * kmax * sizeof *apr);
+    float *bpr = malloc(kmax * n * sizeof *bpr);
+    float *cr = malloc(4 * GEMM_MC * sizeof *cr);
+
+    scale_block(g, i_start, i_end, start, end);
+
+    for (int k0 = 0; k0 < k; k0 += GEMM_KC) {
+        int kc = min(GEMM_KC, k - k0);
+        bool b_real = pack_scaled(g, k0, kc, start, n, bp, bpr);
+        for (int i0 = i_start; i0 < i_end; i0 += GEMM_MC) {
+            int mc = min(GEMM_MC, i_end - i0);
+            bool a_real = g->a.pack(g->a.x, i0, mc, k0, kc, ap, apr);
+            if (a_real && b_real) {
+                // Real product, added to the real parts of C
+                for (int j = 0; j < n; j += 4) {
+                    int cols = min(4, n - j);
+                    gemm_kernel_real(mc, kc, cols, apr, bpr + (size_t) j * kc, cr);
+                    for (int q = 0; q < cols; q++) {
+                        float *c = (float *) (g->c->items[start + j + q].items + i0);
+                        for (int i = 0; i < mc; i++)
+                            c[2*i] += cr[(size_t) q * mc + i];
+                    }
+                }
+                continue;
+            }
+            int j = 0;
+            for (; j + 4 <= n; j += 4) {
+                float _Complex *c[4];
+                for (int q = 0; q < 4; q++)
+                    c[q] = g->c->items[start + j + q].items + i0;
+                if (b_real)
+                    gemm_kernel_4_real_b(mc, kc, ap, bpr + (size_t) j * kc, c);
+                else if (a_real)
+                    gemm_kernel_4_real_a(mc, kc, apr, bp + (size_t) j * kc, c);
+                else
+                    gemm_kernel_4(mc, kc, ap, bp + (size_t) j * kc, c);
+            }
+            for (; j < n; j++) {
+                float _Complex *c = g->c->items[start + j].items + i0;
+                for (int p = 0; p < kc; p++) {
+                    if (!a_real) {
+                        float _Complex b = b_real ? bpr[(size_t) j * kc + p] : bp[(size_t) j * kc + p];
+                        complex_axpy(mc, b, ap + (size_t) p * mc, c);
+                        continue;
+                    }
+                    const float *a = apr + (size_t) p * mc;
+                    float *cf = (float *) c;
+                    float br = crealf(bp[(size_t) j * kc + p]), bi = cimagf(bp[(size_t) j * kc + p]);
+                    for (int i = 0; i < mc; i++) {
+                        cf[2*i] += br * a[i];
+                        cf[2*i+1] += bi * a[i];
+                    }
+                }
+            }
+        }
+    }
+    free(ap);
+    free(bp);
+    free(apr);
+    free(bpr);
+    free(cr);
+}
+
+static void gemm_tiles(int start, int end, void *arg) {
+    const Gemm *g = arg;
+    for (int t = start; t < end; t++) {
+        int i0 = t % g->row_tiles * g->row_step, j0 = t / g->row_tiles * GEMM_NC;
+        g->block(g, i0, min(i0 + g->row_step, g->c->rows), j0, min(j0 + GEMM_NC, g->c->cols));
+    }
+}
+
+// Run the tiles of a product in parallel. Products with fewer blocks of GEMM_NC
+// columns than twice the number of workers, such as the thin products of sketching,
+// also split their rows, by whole blocks of GEMM_MC rows.
+static void run_gemm(Gemm *g) {
+    int col_tiles = (g->c->cols + GEMM_NC - 1) / GEMM_NC;
+    int row_blocks = (g->c->rows + GEMM_MC - 1) / GEMM_MC;
+    int wanted = (2 * scheduler_num_workers() + col_tiles - 1) / col_tiles;
+    int row_tiles = max(1, min(row_blocks, wanted));
+    g->row_step = (row_blocks + row_tiles - 1) / row_tiles * GEMM_MC;
+    g->row_tiles = (g->c->rows + g->row_step - 1) / g->row_step;
+    parallel_for(0, col_tiles * g->row_tiles, 1, gemm_tiles, g);
+}
+
+Matrix *matrix_gemm_packed(float _Complex alpha, GemmOperand a, GemmOperand b, float _Complex beta, Matrix *c) {
+    assert(a.cols == b.rows);
+    if (c == NULL) {
+        c = malloc(sizeof(Matrix));
+        init_matrix(c, "M", a.rows, b.cols);
+        beta = 0.0f;
+    }
+    assert(c->rows == a.rows && c->cols == b.cols);
+    Gemm g = {alpha, a, b, beta, c, gemm_block, 0, 0};
+    run_gemm(&g);
+    return c;
+}
+
+Matrix *matrix_gemm(float _Complex alpha, MatrixView a, MatrixView b, float _Complex beta, Matrix *c) {
+    return matrix_gemm_packed(alpha, view_operand(&a), view_operand(&b), beta, c);
+}
+
+// Split n packed complex numbers into their real parts, imaginary parts and the sums
+// of both
+static void split_parts(size_t n, const float _Complex *p, float *re, float *im, float *sum) {
+    const float *f = (const float *) p;
+    for (size_t i = 0; i < n; i++) {
+        re[i] = f[2*i];
+        im[i] = f[2*i+1];
+        sum[i] = f[2*i] + f[2*i+1];
+    }
+}
+
+// Same as gemm_block with three real products per block: for A = Ar + i Ai and
+// B = Br + i Bi, AB = (T1 - T2) + i (T3 - T1 - T2) with T1 = Ar Br, T2 = Ai Bi and
+// T3 = (Ar + Ai)(Br + Bi)
+static void gemm_3m_block(const Gemm *g, int i_start, int i_end, int start, int end) {
+    int n = end - start, k = g->a.cols;
+    size_t kmax = min(GEMM_KC, k);
+    float _Complex *ap = malloc(GEMM_MC * kmax * sizeof *ap);
+    float _Complex *bp = malloc(kmax * n * sizeof *bp);
+    float *apr = malloc(3 * GEMM_MC * kmax * sizeof *apr);
+    float *bpr = malloc(3 * kmax * n * sizeof *bpr);
+    float *t = malloc(3 * 4 * GEMM_MC * sizeof *t);
+    float *api = apr + GEMM_MC * kmax, *aps = api + GEMM_MC * kmax;
+    float *bpi = bpr + kmax * n, *bps = bpi + kmax * n;
+
+    scale_block(g, i_start, i_end, start, end);
+
+    for (int k0 = 0; k0 < k; k0 += GEMM_KC) {
+        int kc = min(GEMM_KC, k - k0);
+        if (pack_scaled(g, k0, kc, start, n, bp, bpr))
+            widen_real((size_t) kc * n, bpr, 1.0f, bp);
+        split_parts((size_t) kc * n, bp, bpr, bpi, bps);
+        for (int i0 = i_start; i0 < i_end; i0 += GEMM_MC) {
+            int mc = min(GEMM_MC, i_end - i0);
+            if (g->a.pack(g->a.x, i0, mc, k0, kc, ap, apr))
+                widen_real((size_t) mc * kc, apr, 1.0f, ap);
+            split_parts((size_t) mc * kc, ap, apr, api, aps);
+            for (int j = 0; j < n; j += 4) {
+                int cols = min(4, n - j);
+                size_t offset = (size_t) j * kc;
+                float *t1 = t, *t2 = t + 4 * mc, *t3 = t + 8 * mc;
+                gemm_kernel_real(mc, kc, cols, apr, bpr + offset, t1);
+                gemm_kernel_real(mc, kc, cols, api, bpi + offset, t2);
+                gemm_kernel_real(mc, kc, cols, aps, bps + offset, t3);
+                for (int q = 0; q < cols; q++) {
+                    float *c = (float *) (g->c->items[start + j + q].items + i0);
+                    const float *r1 = t1 + (size_t) q * mc, *r2 = t2 + (size_t) q * mc, *r3 = t3 + (size_t) q * mc;
+                    for (int i = 0; i < mc; i++) {
+                        c[2*i] += r1[i] - r2[i];
+                        c[2*i+1] += r3[i] - r1[i] - r2[i];
+                    }
+                }
+            }
+        }
+    }
+    free(ap);
+    free(bp);
+    free(apr);
+    free(bpr);
+    free(t);
+}
+
+Matrix *matrix_gemm_3m(float _Complex alpha, MatrixView a, MatrixView b, float _Complex beta, Matrix *c) {
+    assert(view_cols(a) == view_rows(b));
+    if (c == NULL) {
+        c = malloc(sizeof(Matrix));
+        init_matrix(c, "M", view_rows(a), view_cols(b));
+        beta = 0.0f;
+    }
+    assert(c->rows == view_rows(a) && c->cols == view_cols(b));
+    Gemm g = {alpha, view_operand(&a), view_operand(&b), beta, c, gemm_3m_block, 0, 0};
+    run_gemm(&g);
+    return c;
+}
+
+typedef struct Gemv {
+    float _Complex alpha;
+    MatrixView a;
+    const float _Complex *x;
+    float _Complex beta;
+    float _Complex *y;
+} Gemv;
+
+// y[start:end] = alpha A[start:end, :] x + beta y[start:end], four columns at a time
+static void gemv_rows(int start, int end, void *arg) {
+    const Gemv *g = arg;
+    const Matrix *a = g->a.m;
+    int rows = end - start;
+    float *restrict y = (float *) (g->y + start);
+    if (g->beta == 0.0f)
+        memset(y, 0, rows * sizeof *g->y);
+    else if (g->beta != 1.0f)
+        complex_scal(rows, g->beta, g->y + start);
+
+    // Conjugating A amounts to conjugating x and the result
+    float s = g->a.conj ? -1.0f : 1.0f;
+    if (g->a.conj)
+        for (int i = 0; i < 2 * rows; i += 2)
+            y[i + 1] = -y[i + 1];
+    int j = 0;
+    for (; j + 4 <= a->cols; j += 4) {
+        float xr[4], xi[4];
+        const float *c[4];
+        for (int q = 0; q < 4; q++) {
+            float _Complex z = complex_mult(g->alpha, g->x[j + q]);
+            xr[q] = crealf(z);
+            xi[q] = s * cimagf(z);
+            c[q] = (const float *) (a->items[j + q].items + start);
+        }
+        for (int i = 0; i < rows; i++) {
+            float re = y[2*i], im = y[2*i+1];
+            for (int q = 0; q < 4; q++) {
+                float ar = c[q][2*i], ai = c[q][2*i+1];
+                re += xr[q] * ar - xi[q] * ai;
+                im += xr[q] * ai + xi[q] * ar;
+            }
+            y[2*i] = re;
+            y[2*i+1] = im;
+        }
+    }
+    for (; j < a->cols; j++) {
+        float _Complex z = complex_mult(g->alpha, g->x[j]);
+        complex_axpy(rows, g->a.conj ? conjf(z) : z, a->items[j].items + start, g->y + start);
+    }
+    if (g->a.conj)
+        for (int i = 0; i < 2 * rows; i += 2)
+            y[i + 1] = -y[i + 1];
+}
+
+// y[start:end] = alpha op(A)[start:end, :] x + beta y[start:end] for op = T or H
+static void gemv_trans_rows(int start, int end, void *arg) {
+    const Gemv *g = arg;
+    const Matrix *a = g->a.m;
+    for (int j = start; j < end; j++) {
+        const float *c = (const float *) a->items[j].items;
+        const float *x = (const float *) g->x;
+        // sum of conj(a_i) x_i for A^H, a_i x_i for A^T
+        float s = g->a.conj ? -1.0f : 1.0f;
+        float re = 0.0f, im = 0.0f;
+        for (int i = 0; i < a->rows; i++) {
+            float ar = c[2*i], ai = s * c[2*i+1];
+            re += ar * x[2*i] - ai * x[2*i+1];
+            im += ar * x[2*i+1] + ai * x[2*i];
+        }
+        float _Complex dot = complex_mult(g->alpha, CMPLXF(re, im));
+        g->y[j] = g->beta == 0.0f ? dot : dot + complex_mult(g->beta, g->y[j]);
+    }
+}
+
+Vector *matrix_gemv(float _Complex alpha, MatrixView a, const Vector *x, float _Complex beta, Vector *y) {
+    assert(x->capacity == view_cols(a));
+    if (y == NULL) {
+        y = malloc(sizeof(Vector));
+        init_vector(y, "V", view_rows(a));
+        beta = 0.0f;
+    }
+    assert(y->capacity == view_rows(a));
+    Gemv g = {alpha, a, x->items, beta, y->items};
+    if (a.trans)
+        parallel_for(0, y->capacity, GEMV_COL_GRAIN, gemv_trans_rows, &g);
+    else
+        parallel_for(0, y->capacity, GEMV_ROW_BLOCK, gemv_rows, &g);
+    return y;
+}
+
+Vector *matrix_gemv_batched(float _Complex alpha, MatrixView a, const Vector *xs, int count) {
+    assert(count > 0);
+    // The vectors already have the layout of the columns of a matrix
+    Matrix x = {view_cols(a), count, (Vector *) xs, "X"};
+    for (int k = 0; k < count; k++)
+        assert(xs[k].capacity == x.rows);
+    Matrix *y = matrix_gemm(alpha, a, view_of(&x), 0.0f, NULL);
+    Vector *ys = y->items;
+    free(y);
+    return ys;
 }
 
 Matrix *create_submatrix(const Matrix *m, int row_start, int row_end, int col_start, int col_end) {
     Matrix *sub = malloc(sizeof(Matrix));
     init_matrix(sub, "M", row_end - row_start, col_end - col_start);
-    for (int i = row_start; i < row_end; i++)
-        for (int j = col_start; j < col_end; j++)
-            update_matrix(sub, m->items[j].items[i], i - row_start, j - col_start);
+    for (int j = col_start; j < col_end; j++)
+        memcpy(sub->items[j - col_start].items, m->items[j].items + row_start, sub->rows * sizeof *sub->items[0].items);
     return sub;
 }
 
+void init_matrix_view(Matrix *view, const Matrix *m, int row_start, int row_end, int col_start, int col_end) {
+    assert(0 <= row_start && row_start < row_end && row_end <= m->rows);
+    assert(0 <= col_start && col_start < col_end && col_end <= m->cols);
+    view->rows = row_end - row_start;
+    view->cols = col_end - col_start;
+    view->name = m->name;
+    view->items = malloc(view->cols * sizeof(Vector));
+    for (int j = 0; j < view->cols; j++)
+        init_vector_view(view->items + j, m->items + col_start + j, row_start, row_end);
+}
+
+void free_matrix_view(Matrix *view) {
+    assert(view != NULL);
+    free(view->items);
+    view->items = NULL;
+}
+
 Matrix *set_submatrix(Matrix *m, const Matrix *sub, int row_start, int row_end, int col_start, int col_end) {
-    for (int i = row_start; i < row_end; i++)
-        for (int j = col_start; j < col_end; j++)
-            update_matrix(m, sub->items[j - col_start].items[i - row_start], i, j);
+    for (int j = col_start; j < col_end; j++)
+        memcpy(m->items[j].items + row_start, sub->items[j - col_start].items, (row_end - row_start) * sizeof *sub->items[0].items);
     return m;
 }
 
@@ -104,77 +689,132 @@ Matrix *fast_matrix_mult(const Matrix *m1, const Matrix *m2) {
     // Inner dimensions must be the same
     assert(m1->cols == m2->rows);
 
-    // Sanity checks: Strassen's algorithm will not work if the matrix is not a power of 2
-    bool is_power_of_2 = !(m1->rows & (m1->rows - 1)) && !(m1->cols & (m1->cols - 1));
-    // For 2x2 matrices, call the standard matrix multiplication algorithm
-    bool under_threshold = (m1->rows < THRESHOLD) || (m1->cols < THRESHOLD) || (m2->rows < THRESHOLD) || (m2->cols < THRESHOLD);
-
-    if (is_power_of_2 || under_threshold)
-        return matrix_mult(m1, m2);
-    
+    // Sanity checks: Strassen's algorithm will not work if the matrices are not square with a power of 2 size
     int n = m1->rows;
+    bool is_power_of_2 = !(n & (n - 1)) && m1->cols == n && m2->cols == n;
+    // Small matrices are faster to multiply with the standard algorithm
+    if (!is_power_of_2 || n <= THRESHOLD)
+        return matrix_mult(m1, m2);
+
+    // The quadrants of the operands and of the result are views: nothing is copied
     int half = n / 2;
-    Matrix *A11 = create_submatrix(m1, 0, half, 0, half);
-    const Matrix *A12 = create_submatrix(m1, 0, half, half, n);
-    const Matrix *A21 = create_submatrix(m1, half, n, 0, half);
-    const Matrix *A22 = create_submatrix(m1, half, n, half, n);
-    Matrix *B11 = create_submatrix(m2, 0, half, 0, half);
-    const Matrix *B12 = create_submatrix(m2, 0, half, half, n);
-    Matrix *B21 = create_submatrix(m2, half, n, 0, half);
-    Matrix *B22 = create_submatrix(m2, half, n, half, n);
-
-    Matrix *S1 = matrix_add(B12, B22, false);
-    Matrix *S2 = matrix_add(A11, A12, true);
-    Matrix *S3 = matrix_add(A21, A22, true);
-    Matrix *S4 = matrix_add(B21, B11, false);
-    Matrix *S5 = matrix_add(A11, A22, true);
-    Matrix *S6 = matrix_add(B11, B22, true);
-    Matrix *S7 = matrix_add(A12, A22, false);
-
-    // Recursive calls
-    Matrix *matrices[3][3] = {{A11, S1}, {S2, B22}, {S3, B11}, {A22, S4}, {S5, S6}, {S7, B21}, {S7, S6}};
-    for (int i = 0; i < NUM_THREADS; i++) {
-        pthread_create(&threads[i], NULL, thread_func, (void *)matrices[i]);
-    }
-
-    // Wait for the threads to finish
-    for (int i = 0; i < NUM_THREADS; i++) {
-        pthread_join(threads[i], (void **)&results[i]);
-    }
-
-    const Matrix *P1 = results[0];
-    const Matrix *P2 = results[1];
-    const Matrix *P3 = results[2];
-    const Matrix *P4 = results[3];
-    const Matrix *P5 = results[4];
-    const Matrix *P6 = results[5];
-    const Matrix *P7 = results[6];
-
-    const Matrix *C11 = matrix_add(matrix_add(matrix_add(P5, P4, true), P2, false), P6, true);
-    const Matrix *C12 = matrix_add(P1, P2, true);
-    const Matrix *C21 = matrix_add(P3, P4, true);
-    const Matrix *C22 = matrix_add(matrix_add(P5, P1, true), matrix_add(P3, P7, true), false);
+    Matrix A11, A12, A21, A22, B11, B12, B21, B22;
+    init_matrix_view(&A11, m1, 0, half, 0, half);
+    init_matrix_view(&A12, m1, 0, half, half, n);
+    init_matrix_view(&A21, m1, half, n, 0, half);
+    init_matrix_view(&A22, m1, half, n, half, n);
+    init_matrix_view(&B11, m2, 0, half, 0, half);
+    init_matrix_view(&B12, m2, 0, half, half, n);
+    init_matrix_view(&B21, m2, half, n, 0, half);
+    init_matrix_view(&B22, m2, half, n, half, n);
+
+    Matrix *S1 = matrix_add(&B12, &B22, false);
+    Matrix *S2 = matrix_add(&A11, &A12, true);
+    Matrix *S3 = matrix_add(&A21, &A22, true);
+    Matrix *S4 = matrix_add(&B21, &B11, false);
+    Matrix *S5 = matrix_add(&A11, &A22, true);
+    Matrix *S6 = matrix_add(&B11, &B22, true);
+    Matrix *S7 = matrix_add(&A12, &A22, false);
+    Matrix *S8 = matrix_add(&B21, &B22, true);
+    Matrix *S9 = matrix_add(&A11, &A21, false);
+    Matrix *S10 = matrix_add(&B11, &B12, true);
+
+    // Recursive calls: six products are spawned, the last one runs on the current worker
+    StrassenProduct products[7] = {
+        {&A11, S1, NULL}, {S2, &B22, NULL}, {S3, &B11, NULL}, {&A22, S4, NULL},
+        {S5, S6, NULL}, {S7, S8, NULL}, {S9, S10, NULL}
+    };
+    TaskGroup group;
+    init_task_group(&group);
+    for (int i = 0; i < 6; i++)
+        task_spawn(&group, strassen_product_task, &products[i]);
+    strassen_product_task(&products[6]);
+    task_sync(&group);
+
+    Matrix *P1 = products[0].result;
+    Matrix *P2 = products[1].result;
+    Matrix *P3 = products[2].result;
+    Matrix *P4 = products[3].result;
+    Matrix *P5 = products[4].result;
+    Matrix *P6 = products[5].result;
+    Matrix *P7 = products[6].result;
 
     Matrix *m = malloc(sizeof(Matrix));
     init_matrix(m, "M", m1->rows, m2->cols); // keep outer dimensions
+    Matrix C11, C12, C21, C22;
+    init_matrix_view(&C11, m, 0, half, 0, half);
+    init_matrix_view(&C12, m, 0, half, half, n);
+    init_matrix_view(&C21, m, half, n, 0, half);
+    init_matrix_view(&C22, m, half, n, half, n);
+
+    // Each quadrant is evaluated in a single pass over the products
+    Expr *quadrants[4] = {
+        expr_add(expr_add(expr_add(expr_matrix(P5), expr_matrix(P4), true), expr_matrix(P2), false), expr_matrix(P6), true),
+        expr_add(expr_matrix(P1), expr_matrix(P2), true),
+        expr_add(expr_matrix(P3), expr_matrix(P4), true),
+        expr_add(expr_add(expr_add(expr_matrix(P5), expr_matrix(P1), true), expr_matrix(P3), false), expr_matrix(P7), false)
+    };
+    Matrix *C[4] = {&C11, &C12, &C21, &C22};
+    for (int i = 0; i < 4; i++) {
+        expr_eval_into(quadrants[i], C[i]);
+        free_expr(quadrants[i]);
+    }
 
-    set_submatrix(m, C11, 0, half, 0, half);
-    set_submatrix(m, C12, 0, half, half, n);
-    set_submatrix(m, C21, half, n, 0, half);
-    set_submatrix(m, C22, half, n, half, n);
+    Matrix *views[] = {&A11, &A12, &A21, &A22, &B11, &B12, &B21, &B22, &C11, &C12, &C21, &C22};
+    for (int i = 0; i < 12; i++)
+        free_matrix_view(views[i]);
+    Matrix *temporaries[] = {S1, S2, S3, S4, S5, S6, S7, S8, S9, S10, P1, P2, P3, P4, P5, P6, P7};
+    free_matrices(temporaries, sizeof(temporaries) / sizeof(*temporaries));
     return m;
 }
 
 Matrix *matrix_power(const Matrix *m, int p) {
-    assert(m->rows == m->cols);
-    Matrix *pow = malloc(sizeof(Matrix));
-    init_matrix(pow, "P", m->rows, m->cols);
-    for (int j = 0; j < pow->cols; j++)
-        for (int i = 0; i < pow->rows; i++)
-            update_matrix(pow, i == j ? 1 : 0, i, j);
-    for (int i = 0; i < p; i++)
-        pow = matrix_mult(pow, m);
-    return pow;
+    assert(m->rows == m->cols && p >= 0);
+    if (p == 0)
+        return identity_matrix(m->rows);
+
+    // Square the base for every bit of p, multiplying the result by the base for the bits
+    // that are set. Products go to the spare workspace, which is then swapped in.
+    Matrix *base = matrix_copy(m);
+    Matrix *result = NULL;
+    Matrix *spare = malloc(sizeof(Matrix));
+    init_matrix(spare, "P", m->rows, m->cols);
+    Matrix *tmp;
+    for (; p > 0; p >>= 1) {
+        if (p & 1) {
+            if (result == NULL) {
+                result = matrix_copy(base);
+            } else {
+                matrix_gemm(1.0f, view_of(result), view_of(base), 0.0f, spare);
+                tmp = result, result = spare, spare = tmp;
+            }
+        }
+        if (p > 1) {
+            matrix_gemm(1.0f, view_of(base), view_of(base), 0.0f, spare);
+            tmp = base, base = spare, spare = tmp;
+        }
+    }
+    Matrix *workspaces[] = {base, spare};
+    free_matrices(workspaces, 2);
+    return result;
+}
+
+Vector *matrix_power_vector(const Matrix *m, int p, const Vector *v) {
+    assert(m->rows == m->cols && m->cols == v->capacity && p >= 0);
+    Vector *x = malloc(sizeof(Vector));
+    Vector *y = malloc(sizeof(Vector));
+    init_vector(x, "V", v->capacity);
+    init_vector(y, "V", v->capacity);
+    memcpy(x->items, v->items, v->capacity * sizeof *v->items);
+    for (int i = 0; i < p; i++) {
+        matrix_gemv(1.0f, view_of(m), x, 0.0f, y);
+        Vector *tmp = x;
+        x = y;
+        y = tmp;
+    }
+    free_vector(y);
+    free(y);
+    return x;
 }
 
 Matrix *matrix_hadamard_prod(const Matrix *m1, const Matrix *m2) {
@@ -189,15 +829,61 @@ Matrix *matrix_hadamard_prod(const Matrix *m1, const Matrix *m2) {
     return m;
 }
 
+typedef struct Kronecker {
+    const Matrix *a;
+    const Matrix *b;
+    Matrix *m;
+} Kronecker;
+
+// Column jA * cols(B) + jB of A (x) B stacks the blocks a(iA, jA) B[:, jB]
+static void kronecker_columns(int start, int end, void *arg) {
+    const Kronecker *k = arg;
+    int rb = k->b->rows, cb = k->b->cols;
+    for (int j = start; j < end; j++) {
+        const float _Complex *a = k->a->items[j / cb].items;
+        const float _Complex *b = k->b->items[j % cb].items;
+        float _Complex *col = k->m->items[j].items;
+        for (int i = 0; i < k->a->rows; i++)
+            complex_axpy(rb, a[i], b, col + (size_t) i * rb);
+    }
+}
+
 Matrix *matrix_kronecker_prod(const Matrix *m1, const Matrix *m2) {
     Matrix *m = malloc(sizeof(Matrix));
     init_matrix(m, "M", m1->rows*m2->rows, m1->cols*m2->cols);
-    for (int j = 0; j < m->cols; j++) {
-        for (int i = 0; i < m->rows; i++) {
-            update_matrix(m, matrix_scalar_mult(m1->items[j / m2->cols].items[i / m2->rows], m2)->items[j % m2->cols].items[i % m2->rows], i, j);
-        }
-    }
-    return matrix_transpose(m);
+    Kronecker k = {m1, m2, m};
+    parallel_for(0, m->cols, 1, kronecker_columns, &k);
+    return m;
+}
+
+// View the elements of v as the columns of a rows x cols matrix, without copying them
+static void reshape_view(Matrix *view, const Vector *v, int rows, int cols) {
+    assert(v->capacity == rows * cols);
+    view->rows = rows;
+    view->cols = cols;
+    view->name = v->name;
+    view->items = malloc(cols * sizeof(Vector));
+    for (int j = 0; j < cols; j++)
+        init_vector_view(view->items + j, v, j * rows, (j + 1) * rows);
+}
+
+Vector *kronecker_mult_vector(const Matrix *a, const Matrix *b, const Vector *x) {
+    assert(x->capacity == a->cols * b->cols);
+    // (A (x) B) vec(X) = vec(B X A^T), X being x reshaped into cols(B) x cols(A)
+    Matrix xm, ym;
+    reshape_view(&xm, x, b->cols, a->cols);
+    Matrix *bx = matrix_gemm(1.0f, view_of(b), view_of(&xm), 0.0f, NULL);
+
+    Vector *y = malloc(sizeof(Vector));
+    init_vector(y, "V", a->rows * b->rows);
+    reshape_view(&ym, y, b->rows, a->rows);
+    matrix_gemm(1.0f, view_of(bx), view_transpose(a), 0.0f, &ym);
+
+    free_matrix_view(&xm);
+    free_matrix_view(&ym);
+    free_matrix(bx);
+    free(bx);
+    return y;
 }
 
 Matrix *vector_tensor_prod(const Vector *u, const Vector *v) {
@@ -209,26 +895,145 @@ Matrix *vector_tensor_prod(const Vector *u, const Vector *v) {
     return m;
 }
 
+// Transpose the 4x4 block whose columns start at src[0..3] into the columns starting at
+// dst[0..3]: dst[r][c] = src[c][r]. Complex floats are moved as 64-bit lanes.
+static inline void transpose_4x4(float _Complex *const src[4], float _Complex *const dst[4], bool conj) {
+    #if defined(__AVX__)
+    __m256d c0 = _mm256_loadu_pd((const double *) src[0]);
+    __m256d c1 = _mm256_loadu_pd((const double *) src[1]);
+    __m256d c2 = _mm256_loadu_pd((const double *) src[2]);
+    __m256d c3 = _mm256_loadu_pd((const double *) src[3]);
+    __m256d t0 = _mm256_unpacklo_pd(c0, c1), t1 = _mm256_unpackhi_pd(c0, c1);
+    __m256d t2 = _mm256_unpacklo_pd(c2, c3), t3 = _mm256_unpackhi_pd(c2, c3);
+    __m256d r[4] = {
+        _mm256_permute2f128_pd(t0, t2, 0x20), _mm256_permute2f128_pd(t1, t3, 0x20),
+        _mm256_permute2f128_pd(t0, t2, 0x31), _mm256_permute2f128_pd(t1, t3, 0x31)
+    };
+    const __m256 sign = _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+    for (int k = 0; k < 4; k++) {
+        if (conj)
+            r[k] = _mm256_castps_pd(_mm256_xor_ps(_mm256_castpd_ps(r[k]), sign));
+        _mm256_storeu_pd((double *) dst[k], r[k]);
+    }
+    #elif defined(__ARM_NEON)
+    const float32x4_t sign = {1.0f, -1.0f, 1.0f, -1.0f};
+    for (int a = 0; a < 4; a += 2)
+        for (int b = 0; b < 4; b += 2) {
+            float64x2_t x = vreinterpretq_f64_f32(vld1q_f32((const float *) (src[b] + a)));
+            float64x2_t y = vreinterpretq_f64_f32(vld1q_f32((const float *) (src[b + 1] + a)));
+            float32x4_t r0 = vreinterpretq_f32_f64(vtrn1q_f64(x, y));
+            float32x4_t r1 = vreinterpretq_f32_f64(vtrn2q_f64(x, y));
+            if (conj) {
+                r0 = vmulq_f32(r0, sign);
+                r1 = vmulq_f32(r1, sign);
+            }
+            vst1q_f32((float *) (dst[a] + b), r0);
+            vst1q_f32((float *) (dst[a + 1] + b), r1);
+        }
+    #else
+    float _Complex tmp[4][4];
+    for (int c = 0; c < 4; c++)
+        for (int r = 0; r < 4; r++)
+            tmp[r][c] = conj ? conjf(src[c][r]) : src[c][r];
+    for (int r = 0; r < 4; r++)
+        memcpy(dst[r], tmp[r], sizeof tmp[r]);
+    #endif
+}
+
+// Transpose the rows x cols block of src at (si, sj) into the block of dst at (di, dj)
+static void transpose_tile(const Vector *src, int si, int sj, Vector *dst, int di, int dj, int rows, int cols, bool conj) {
+    int r4 = rows / 4 * 4, c4 = cols / 4 * 4;
+    for (int j = 0; j < c4; j += 4)
+        for (int i = 0; i < r4; i += 4) {
+            float _Complex *s[4], *d[4];
+            for (int k = 0; k < 4; k++) {
+                s[k] = src[sj + j + k].items + si + i;
+                d[k] = dst[dj + i + k].items + di + j;
+            }
+            transpose_4x4(s, d, conj);
+        }
+    // Leftover rows and columns
+    for (int j = 0; j < cols; j++)
+        for (int i = (j < c4 ? r4 : 0); i < rows; i++) {
+            float _Complex z = src[sj + j].items[si + i];
+            dst[dj + i].items[di + j] = conj ? conjf(z) : z;
+        }
+}
+
+typedef struct Transpose {
+    const Matrix *src;
+    Matrix *dst;
+    bool conj;
+} Transpose;
+
+// Transpose rows [i0, i1) x columns [j0, j1) of src, halving the larger side until the
+// block fits in a tile, so that every level of the cache is used without tuning
+static void transpose_block(const Transpose *t, int i0, int i1, int j0, int j1) {
+    if (i1 - i0 <= TRANSPOSE_TILE && j1 - j0 <= TRANSPOSE_TILE) {
+        transpose_tile(t->src->items, i0, j0, t->dst->items, j0, i0, i1 - i0, j1 - j0, t->conj);
+    } else if (i1 - i0 >= j1 - j0) {
+        transpose_block(t, i0, i0 + (i1 - i0) / 2, j0, j1);
+        transpose_block(t, i0 + (i1 - i0) / 2, i1, j0, j1);
+    } else {
+        transpose_block(t, i0, i1, j0, j0 + (j1 - j0) / 2);
+        transpose_block(t, i0, i1, j0 + (j1 - j0) / 2, j1);
+    }
+}
+
+static void transpose_strips(int start, int end, void *arg) {
+    const Transpose *t = arg;
+    transpose_block(t, 0, t->src->rows, start, end);
+}
+
+// Exchange the tile at (i0, j0) with the transpose of its mirror at (j0, i0)
+static void swap_tiles(Matrix *m, int i0, int j0, bool conj) {
+    int rows = min(TRANSPOSE_TILE, m->rows - i0), cols = min(TRANSPOSE_TILE, m->rows - j0);
+    float _Complex buffer[TRANSPOSE_TILE * TRANSPOSE_TILE];
+    Vector saved[TRANSPOSE_TILE];
+    for (int j = 0; j < cols; j++) {
+        saved[j].items = buffer + j * TRANSPOSE_TILE;
+        memcpy(saved[j].items, m->items[j0 + j].items + i0, rows * sizeof *buffer);
+    }
+    if (i0 != j0)
+        transpose_tile(m->items, j0, i0, m->items, i0, j0, cols, rows, conj);
+    transpose_tile(saved, 0, 0, m->items, j0, i0, rows, cols, conj);
+}
+
+typedef struct InplaceTranspose {
+    Matrix *m;
+    bool conj;
+} InplaceTranspose;
+
+static void transpose_tile_rows(int start, int end, void *arg) {
+    const InplaceTranspose *t = arg;
+    for (int i0 = start * TRANSPOSE_TILE; i0 < end * TRANSPOSE_TILE; i0 += TRANSPOSE_TILE)
+        for (int j0 = i0; j0 < t->m->cols; j0 += TRANSPOSE_TILE)
+            swap_tiles(t->m, i0, j0, t->conj);
+}
+
 Matrix *matrix_transpose(const Matrix *m) {
     Matrix *t = malloc(sizeof(Matrix));
     init_matrix(t, "T", m->cols, m->rows);
-
-    for (int j = 0; j < t->cols; j++)
-        for (int i = 0; i < t->rows; i++)
-            t->items[j].items[i] = m->items[i].items[j];
+    Transpose args = {m, t, false};
+    parallel_for(0, m->cols, TRANSPOSE_TILE, transpose_strips, &args);
     return t;
 }
 
 Matrix *matrix_conj_transpose(const Matrix *m) {
     Matrix *t = malloc(sizeof(Matrix));
     init_matrix(t, "T", m->cols, m->rows);
-
-    for (int j = 0; j < t->cols; j++)
-        for (int i = 0; i < t->rows; i++)
-            t->items[j].items[i] = conj(m->items[i].items[j]);
+    Transpose args = {m, t, true};
+    parallel_for(0, m->cols, TRANSPOSE_TILE, transpose_strips, &args);
     return t;
 }
 
+void matrix_transpose_inplace(Matrix *m, bool conj) {
+    assert(m->rows == m->cols);
+    // Each task swaps a row of tiles above the diagonal with the matching column below it
+    InplaceTranspose args = {m, conj};
+    parallel_for(0, (m->rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE, 1, transpose_tile_rows, &args);
+}
+
 Matrix *matrix_cofactor(const Matrix *m) {
     assert(m->rows == m->cols);
     Matrix *c = malloc(sizeof(Matrix));
@@ -257,51 +1062,33 @@ Matrix *matrix_adjoint(const Matrix *m) {
 
 Matrix *matrix_inverse(const Matrix *m) {
     assert(m->rows == m->cols);
-    Matrix *inv = malloc(sizeof(Matrix));
-    init_matrix(inv, "I", m->rows, m->cols);
-
-    float det = matrix_determinant(m);
-    for (int j = 0; j < inv->cols; j++)
-        for (int i = 0; i < inv->rows; i++)
-            update_matrix(inv, matrix_adjoint(m)->items[j].items[i] / det, i, j);
+    LU *f = lu_factorize(m);
+    Matrix *inv = lu_inverse(f);
+    free_lu(f);
+    free(f);
     return inv;
 }
 
 Matrix *matrix_eigenvalues(const Matrix *m) {
     assert(m->rows == m->cols);
+    Eigen *e = matrix_is_hermitian(m) ? matrix_hermitian_eigen(m, false) : matrix_eigen(m, false);
+    if (e == NULL)
+        return NULL;
     Matrix *eig = malloc(sizeof(Matrix));
     init_matrix(eig, "E", m->rows, 1);
-    for (int i = 0; i < eig->rows; i++) {
-        Matrix *sub = malloc(sizeof(Matrix));
-        init_matrix(sub, "S", m->rows-1, m->cols-1);
-        for (int j = 0; j < m->rows; j++) {
-            if (j == i) continue;
-            for (int k = 0; k < m->cols; k++) {
-                if (k == 0) continue;
-                update_matrix(sub, m->items[j].items[k], j > i ? j-1 : j, k-1);
-            }
-        }
-        update_matrix(eig, matrix_determinant(sub) / m->items[i].items[0], i, 0);
-    }
+    for (int i = 0; i < eig->rows; i++)
+        update_matrix(eig, e->values->items[i], i, 0);
+    free_eigen(e);
+    free(e);
     return eig;
 }
 
 float matrix_determinant(const Matrix *m) {
     assert(m->rows == m->cols);
-    if (m->rows == 1) return m->items[0].items[0];
-    float det = 0.0f;
-    for (int i = 0; i < m->rows; i++) {
-        Matrix *sub = malloc(sizeof(Matrix));
-        init_matrix(sub, "S", m->rows-1, m->cols-1);
-        for (int j = 0; j < m->rows; j++) {
-            if (j == i) continue;
-            for (int k = 0; k < m->cols; k++) {
-                if (k == 0) continue;
-                update_matrix(sub, m->items[j].items[k], j > i ? j-1 : j, k-1);
-            }
-        }
-        det += m->items[i].items[0] * matrix_determinant(sub) * (i % 2 == 0 ? 1 : -1);
-    }
+    LU *f = lu_factorize(m);
+    float det = crealf(lu_determinant(f));
+    free_lu(f);
+    free(f);
     return det;
 }
 
@@ -334,18 +1121,43 @@ Matrix *matrix_rotate_right(const Matrix *m) {
 }
 
 bool matrix_is_symmetric(const Matrix *m) {
+    assert(m->rows == m->cols);
+    // Tiles on and below the diagonal are compared with the mirrored tiles, which stay in
+    // cache, and the scan stops at the first tile that differs
+    int n = m->rows;
+    for (int jb = 0; jb < n; jb += TRANSPOSE_TILE)
+        for (int ib = jb; ib < n; ib += TRANSPOSE_TILE) {
+            bool differ = false;
+            for (int j = jb; j < min(jb + TRANSPOSE_TILE, n); j++) {
+                const float _Complex *col = m->items[j].items;
+                for (int i = ib; i < min(ib + TRANSPOSE_TILE, n); i++)
+                    differ |= col[i] != m->items[i].items[j];
+            }
+            if (differ) return false;
+        }
+    return true;
+}
+
+bool matrix_is_hermitian(const Matrix *m) {
     assert(m->rows == m->cols);
     for (int j = 0; j < m->cols; j++)
-        for (int i = 0; i < m->rows; i++)
-            if (m->items[i].items[j] != m->items[j].items[i]) return false;
+        for (int i = j; i < m->rows; i++)
+            if (m->items[i].items[j] != conjf(m->items[j].items[i])) return false;
     return true;
 }
 
 bool matrix_is_diagonal(const Matrix *m) {
     assert(m->rows == m->cols);
-    for (int j = 0; j < m->cols; j++)
-        for (int i = 0; i < m->rows; i++)
-            if (i != j && m->items[i].items[j] != 0) return false;
+    // Branch-free checks of the parts of each column above and below the diagonal
+    for (int j = 0; j < m->cols; j++) {
+        const float *col = (const float *) m->items[j].items;
+        bool nonzero = false;
+        for (int i = 0; i < 2*j; i++)
+            nonzero |= col[i] != 0.0f;
+        for (int i = 2*j + 2; i < 2*m->rows; i++)
+            nonzero |= col[i] != 0.0f;
+        if (nonzero) return false;
+    }
     return true;
 }
 
@@ -371,33 +1183,106 @@ bool matrix_is_real(Matrix *m) {
     return true;
 }
 
-bool matrix_is_stochastic(Matrix *m) {
-    // For simplicity, check that there is no imaginary part
-    assert(matrix_is_real(m));
-    // The sum of each line must be 1
+// Sum the rows and columns of m in a single pass over its columns, stopping early with
+// false if an element is negative or not real
+static bool stochastic_sums(const Matrix *m, float *row_sums, float *col_sums) {
+    memset(row_sums, 0, m->rows * sizeof *row_sums);
     for (int j = 0; j < m->cols; j++) {
+        const float *col = (const float *) m->items[j].items;
+        bool invalid = false;
         float sum = 0.0f;
         for (int i = 0; i < m->rows; i++) {
-            float curr = m->items[i].items[j];
-            if (curr < 0.0f) return false;
-            sum += curr;
+            invalid |= (col[2*i] < 0.0f) | (col[2*i+1] != 0.0f);
+            row_sums[i] += col[2*i];
+            sum += col[2*i];
         }
-        if (sum != 1.0f) return false;
+        if (invalid) return false;
+        col_sums[j] = sum;
     }
     return true;
 }
 
+static bool all_ones(const float *sums, int n) {
+    for (int i = 0; i < n; i++)
+        if (sums[i] != 1.0f) return false;
+    return true;
+}
+
+bool matrix_is_stochastic(Matrix *m) {
+    // The sum of each line must be 1, complex matrices are not stochastic
+    float *row_sums = malloc(m->rows * sizeof *row_sums), *col_sums = malloc(m->cols * sizeof *col_sums);
+    bool stochastic = stochastic_sums(m, row_sums, col_sums) && all_ones(row_sums, m->rows);
+    free(row_sums);
+    free(col_sums);
+    return stochastic;
+}
+
 bool matrix_is_doubly_stochastic(Matrix *m) {
-    if (!matrix_is_stochastic(m)) return false;
-    // The sum of each column must be 1
+    // The sum of each line and column must be 1
+    float *row_sums = malloc(m->rows * sizeof *row_sums), *col_sums = malloc(m->cols * sizeof *col_sums);
+    bool stochastic = stochastic_sums(m, row_sums, col_sums) && all_ones(row_sums, m->rows) && all_ones(col_sums, m->cols);
+    free(row_sums);
+    free(col_sums);
+    return stochastic;
+}
+
+// Number of samples after which a property tester rejects a matrix epsilon-far from the
+// property with probability at least 1 - (1 - epsilon)^(2 / epsilon) > 1 - e^-2
+static int property_test_samples(float epsilon) {
+    assert(epsilon > 0.0f && epsilon <= 1.0f);
+    return (int) ceilf(2.0f / epsilon);
+}
+
+bool matrix_probably_symmetric(const Matrix *m, float epsilon) {
+    assert(m->rows == m->cols);
+    for (int s = property_test_samples(epsilon); s > 0; s--) {
+        int i = rand() % m->rows, j = rand() % m->cols;
+        if (m->items[j].items[i] != m->items[i].items[j]) return false;
+    }
+    return true;
+}
+
+bool matrix_probably_diagonal(const Matrix *m, float epsilon) {
+    assert(m->rows == m->cols);
+    for (int s = property_test_samples(epsilon); s > 0; s--) {
+        int i = rand() % m->rows, j = rand() % m->cols;
+        if (i != j && m->items[j].items[i] != 0) return false;
+    }
+    return true;
+}
+
+// Check that the elements of column j are real, non-negative and sum to 1
+static bool column_is_stochastic(const Matrix *m, int j) {
+    float sum = 0.0f;
     for (int i = 0; i < m->rows; i++) {
-        float sum = 0.0f;
-        for (int j = 0; j < m->cols; j++) {
-            float curr = m->items[i].items[j];
-            if (curr < 0.0f) return false;
-            sum += curr;
-        }
-        if (sum != 1.0f) return false;
+        float _Complex z = m->items[j].items[i];
+        if (crealf(z) < 0.0f || cimagf(z) != 0.0f) return false;
+        sum += crealf(z);
+    }
+    return sum == 1.0f;
+}
+
+// Same for row i, whose elements live in different columns
+static bool row_is_stochastic(const Matrix *m, int i) {
+    float sum = 0.0f;
+    for (int j = 0; j < m->cols; j++) {
+        float _Complex z = m->items[j].items[i];
+        if (crealf(z) < 0.0f || cimagf(z) != 0.0f) return false;
+        sum += crealf(z);
+    }
+    return sum == 1.0f;
+}
+
+bool matrix_probably_stochastic(const Matrix *m, float epsilon) {
+    for (int s = property_test_samples(epsilon); s > 0; s--)
+        if (!row_is_stochastic(m, rand() % m->rows)) return false;
+    return true;
+}
+
+bool matrix_probably_doubly_stochastic(const Matrix *m, float epsilon) {
+    for (int s = property_test_samples(epsilon); s > 0; s--) {
+        if (!row_is_stochastic(m, rand() % m->rows)) return false;
+        if (!column_is_stochastic(m, rand() % m->cols)) return false;
     }
     return true;
 }
@@ -438,11 +1323,142 @@ float matrix_Linf_norm(const Matrix *m) {
 }
 
 float matrix_frobenius_norm(const Matrix *m) {
+    // |z|^2, where pow(z, 2) would only keep the real part of z
     float norm = 0.0f;
-    for (int j = 0; j < m->cols; j++)
-        for (int i = 0; i < m->rows; i++)
-            norm += pow(m->items[j].items[i], 2);
-    return sqrt(norm);
+    for (int j = 0; j < m->cols; j++) {
+        const float *col = (const float *) m->items[j].items;
+        for (int i = 0; i < 2*m->rows; i++)
+            norm += col[i] * col[i];
+    }
+    return sqrtf(norm);
+}
+
+// Summary of a chunk of columns, with its own row sums
+typedef struct StatsChunk {
+    float *row_sums;
+    double squares;
+    float max_col_sum, max_abs, min_abs;
+    float _Complex trace;
+    bool nonreal, fractional;
+} StatsChunk;
+
+typedef struct StatsPass {
+    const Matrix *m;
+    MatrixStats *s;
+    StatsChunk *chunks;
+    int nchunks;
+} StatsPass;
+
+// Partial summaries of the elements of a column, one per lane of STATS_LANES elements,
+// so that the reductions can be carried in vector registers
+typedef struct StatsLanes {
+    float sum[STATS_LANES], squares[STATS_LANES], max_abs[STATS_LANES], min_abs[STATS_LANES];
+    int nonreal[STATS_LANES], fractional[STATS_LANES];
+} StatsLanes;
+
+static inline void stats_element(StatsLanes *s, int l, const float *z, float *restrict row_sum) {
+    float re = z[0], im = z[1];
+    float sq = re * re + im * im, a = sqrtf(sq);
+    s->sum[l] += a;
+    s->squares[l] += sq;
+    *row_sum += a;
+    s->max_abs[l] = a > s->max_abs[l] ? a : s->max_abs[l];
+    s->min_abs[l] = a < s->min_abs[l] ? a : s->min_abs[l];
+    s->nonreal[l] |= im != 0.0f;
+    // |re| rounded to the nearest integer by adding and removing 2^23, below which the
+    // sum has no fractional bits (at and above it, every float is an integer)
+    float t = fabsf(re), rounded = (t + 0x1p23f) - 0x1p23f;
+    s->fractional[l] |= (fabsf(im) > 1e-6f) | ((t < 0x1p23f) & (fabsf(t - rounded) > 1e-6f));
+}
+
+static void stats_chunks(int start, int end, void *arg) {
+    const StatsPass *p = arg;
+    const Matrix *m = p->m;
+    for (int c = start; c < end; c++) {
+        StatsChunk *k = p->chunks + c;
+        k->row_sums = calloc(m->rows, sizeof *k->row_sums);
+        k->max_abs = 0.0f;
+        k->min_abs = INFINITY;
+        float *restrict row_sums = k->row_sums;
+        for (int j = (long) m->cols * c / p->nchunks; j < (long) m->cols * (c + 1) / p->nchunks; j++) {
+            const float *restrict col = (const float *) m->items[j].items;
+            StatsLanes s = {0};
+            for (int l = 0; l < STATS_LANES; l++) {
+                s.max_abs[l] = 0.0f;
+                s.min_abs[l] = INFINITY;
+            }
+            int i = 0;
+            for (; i + STATS_LANES <= m->rows; i += STATS_LANES)
+                for (int l = 0; l < STATS_LANES; l++)
+                    stats_element(&s, l, col + 2 * (i + l), row_sums + i + l);
+            for (; i < m->rows; i++)
+                stats_element(&s, 0, col + 2 * i, row_sums + i);
+
+            float sum = 0.0f;
+            for (int l = 0; l < STATS_LANES; l++) {
+                sum += s.sum[l];
+                k->squares += s.squares[l];
+                k->max_abs = fmaxf(k->max_abs, s.max_abs[l]);
+                k->min_abs = fminf(k->min_abs, s.min_abs[l]);
+                k->nonreal |= s.nonreal[l];
+                k->fractional |= s.fractional[l];
+            }
+            p->s->col_sums[j] = sum;
+            k->max_col_sum = fmaxf(k->max_col_sum, sum);
+            if (m->rows == m->cols)
+                k->trace += m->items[j].items[j];
+        }
+    }
+}
+
+static void stats_reduce_rows(int start, int end, void *arg) {
+    const StatsPass *p = arg;
+    for (int i = start; i < end; i++) {
+        float sum = 0.0f;
+        for (int c = 0; c < p->nchunks; c++)
+            sum += p->chunks[c].row_sums[i];
+        p->s->row_sums[i] = sum;
+    }
+}
+
+MatrixStats *matrix_stats(const Matrix *m) {
+    MatrixStats *s = malloc(sizeof(MatrixStats));
+    s->row_sums = malloc(m->rows * sizeof *s->row_sums);
+    s->col_sums = malloc(m->cols * sizeof *s->col_sums);
+
+    StatsPass p = {m, s, NULL, min(scheduler_num_workers(), max(m->cols / STATS_COL_GRAIN, 1))};
+    p.chunks = calloc(p.nchunks, sizeof *p.chunks);
+    parallel_for(0, p.nchunks, 1, stats_chunks, &p);
+    parallel_for(0, m->rows, GEMV_ROW_BLOCK, stats_reduce_rows, &p);
+
+    double squares = 0.0;
+    s->Linf_norm = 0.0f;
+    s->max_abs = 0.0f;
+    s->min_abs = INFINITY;
+    s->trace = 0.0f;
+    s->is_real = s->is_integral = true;
+    for (int c = 0; c < p.nchunks; c++) {
+        StatsChunk *k = p.chunks + c;
+        squares += k->squares;
+        s->Linf_norm = fmaxf(s->Linf_norm, k->max_col_sum);
+        s->max_abs = fmaxf(s->max_abs, k->max_abs);
+        s->min_abs = fminf(s->min_abs, k->min_abs);
+        s->trace += k->trace;
+        s->is_real = s->is_real && !k->nonreal;
+        s->is_integral = s->is_integral && !k->fractional;
+        free(k->row_sums);
+    }
+    s->frobenius_norm = sqrt(squares);
+    s->L1_norm = 0.0f;
+    for (int i = 0; i < m->rows; i++)
+        s->L1_norm = fmaxf(s->L1_norm, s->row_sums[i]);
+    free(p.chunks);
+    return s;
+}
+
+void free_matrix_stats(MatrixStats *s) {
+    free(s->row_sums);
+    free(s->col_sums);
 }
 
 void print_matrix(Matrix *m) {
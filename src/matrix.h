@@ -2,9 +2,25 @@
 #define MATRIX_HEADER
 
 #include "vector.h"
+#include "scheduler.h"
 
 #define MAX_MATRIX_DIM (int)1e4
-#define THRESHOLD 4
+// Size under which Strassen's algorithm falls back to the standard multiplication
+#define THRESHOLD 64
+// Side of the blocks transposed within cache by the recursive transpositions
+#define TRANSPOSE_TILE 32
+// Blocking of the matrix product: panels of GEMM_MC x GEMM_KC elements of the left
+// operand are packed to stay in L2, the right operand being processed by GEMM_NC columns
+#define GEMM_MC 128
+#define GEMM_KC 256
+#define GEMM_NC 64
+// Rows of y (respectively columns of A^T) handled by a single task of the GEMV
+#define GEMV_ROW_BLOCK 2048
+#define GEMV_COL_GRAIN 16
+// Columns summarised by a single task of matrix_stats
+#define STATS_COL_GRAIN 64
+// Partial summaries of a column kept by matrix_stats, one per vector lane
+#define STATS_LANES 8
 
 typedef struct Matrix {
     int rows;
@@ -13,19 +29,81 @@ typedef struct Matrix {
     char *name;
 } Matrix;
 
-// Threading part
-#define NUM_THREADS 8
+// Operand of a product read through its transpose and/or conjugate without copying
+// it. Its columns can sit anywhere in memory, so views of column ranges are free.
+typedef struct MatrixView {
+    const Matrix *m;
+    bool trans;     // read m^T instead of m
+    bool conj;      // conjugate the elements of m
+} MatrixView;
+
+// Copies rows [i0, i0+rows) x columns [j0, j0+cols) of the operand x of a product,
+// column by column, to r if they have no imaginary part and to p otherwise, and
+// returns whether r was filled. Lets matrices stored in other formats be decoded
+// block by block into the packed buffers of the product.
+typedef bool (*pack_func)(const void *x, int i0, int rows, int j0, int cols, float _Complex *p, float *r);
+
+// Operand of matrix_gemm_packed, known only through its size and its pack_func
+typedef struct GemmOperand {
+    int rows;
+    int cols;
+    pack_func pack;
+    const void *x;
+} GemmOperand;
+
+// Summary of a matrix, gathered in a single pass over its elements by matrix_stats
+typedef struct MatrixStats {
+    float L1_norm;              // largest absolute row sum, as matrix_L1_norm
+    float Linf_norm;            // largest absolute column sum, as matrix_Linf_norm
+    float frobenius_norm;
+    float max_abs;              // largest magnitude of an element
+    float min_abs;              // smallest magnitude of an element
+    float _Complex trace;       // 0 for a rectangular matrix
+    bool is_real;
+    bool is_integral;           // within the tolerance of vector_is_integral
+    float *row_sums;            // absolute sum of each row
+    float *col_sums;            // absolute sum of each column
+} MatrixStats;
+
+/**
+ * @brief view a matrix as it is
+ * 
+ * @param m matrix
+ * @return MatrixView the view of m
+ */
+static inline MatrixView view_of(const Matrix *m) {
+    return (MatrixView) {m, false, false};
+}
 
-pthread_t threads[NUM_THREADS];
-Matrix *results[NUM_THREADS];
+/**
+ * @brief view the transpose of a matrix without copying it
+ * 
+ * @param m matrix
+ * @return MatrixView the view of m^T
+ */
+static inline MatrixView view_transpose(const Matrix *m) {
+    return (MatrixView) {m, true, false};
+}
 
-void *thread_func(void *arg);
+/**
+ * @brief view the conjugate transpose of a matrix without copying it
+ * 
+ * @param m matrix
+ * @return MatrixView the view of m^H
+ */
+static inline MatrixView view_conj_transpose(const Matrix *m) {
+    return (MatrixView) {m, true, true};
+}
 
 // ############################ MATRIX TYPE CONSTRUCTION ###############################
 
 /**
  * @brief Initialise a new matrix full of zeros
  * 
+ * Unless the allocation policy is ALLOC_LOCAL (see numa.h), blocks of GEMM_NC columns
+ * are zero-filled in parallel, so that their pages are first touched by the workers
+ * that compute them.
+ * 
  * @param m matrix to initialise
  * @param name matrix id
  * @param rows number of rows
@@ -50,17 +128,48 @@ void free_matrix(Matrix *m);
  */
 void update_matrix(Matrix *m, float _Complex n, int row, int col);
 
+/**
+ * @brief Create a copy of a matrix
+ * 
+ * @param m matrix
+ * @return Matrix* new matrix with the same elements
+ */
+Matrix *matrix_copy(const Matrix *m);
+
 // ################################ MATRIX POPULATION ##################################
 
 /**
  * @brief Create a random matrix containing +/- 1 with equal probability
  * 
+ * Blocks of GEMM_NC columns are filled in parallel, each from its own splitmix64
+ * stream, so that the matrix only depends on the state of rand(), from which the
+ * base seed of the streams is drawn, and not on the number of workers.
+ * 
  * @param rows # of rows
  * @param cols # of columns
  * @return Matrix* the resulting matrix
  */
 Matrix *rademacher_matrix(int rows, int cols);
 
+/**
+ * @brief Create a random matrix of independent standard gaussians (Box-Muller)
+ * 
+ * Filled in parallel as rademacher_matrix.
+ * 
+ * @param rows # of rows
+ * @param cols # of columns
+ * @return Matrix* the resulting matrix
+ */
+Matrix *gaussian_matrix(int rows, int cols);
+
+/**
+ * @brief Create an identity matrix
+ * 
+ * @param n # of rows and columns
+ * @return Matrix* the resulting matrix
+ */
+Matrix *identity_matrix(int n);
+
 // ############################ MATRIX OPERATIONS ####################################
 
 /**
@@ -87,14 +196,105 @@ Matrix *matrix_scalar_mult(float _Complex n, const Matrix *m);
  * 
  * @param m1 first matrix
  * @param m2 second matrix
- * @param div indicator of division
  * @return resultant matrix
  */
 Matrix *matrix_mult(const Matrix *m1, const Matrix *m2);
 
 /**
- * @brief Helper function for fast matrix multiplication, wherein a submatrix is created
- * from a matrix m
+ * @brief compute C = alpha op(A) op(B) + beta C, op being encoded in the views
+ * 
+ * Blocks of both operands are packed with their transposition and conjugation applied,
+ * so that every combination of views costs the same as a plain product. Blocks of
+ * GEMM_NC columns of C are computed in parallel, and so are blocks of GEMM_MC rows when
+ * C has too few columns to keep every worker busy. Packed blocks without imaginary part
+ * are detected and multiplied with real arithmetic, so that products of real matrices
+ * take a quarter of the multiplications of complex ones.
+ * 
+ * @param alpha scalar multiplying the product
+ * @param a left operand
+ * @param b right operand
+ * @param beta scalar multiplying c (ignored if c is NULL)
+ * @param c matrix to update, or NULL to return a new matrix
+ * @return Matrix* the updated or new matrix C
+ */
+Matrix *matrix_gemm(float _Complex alpha, MatrixView a, MatrixView b, float _Complex beta, Matrix *c);
+
+/**
+ * @brief wrap a view as an operand of matrix_gemm_packed
+ * 
+ * @param v view, which must outlive the operand
+ * @return GemmOperand operand reading op(m)
+ */
+GemmOperand view_operand(const MatrixView *v);
+
+/**
+ * @brief compute C = alpha A B + beta C, A and B being packed by their pack_func
+ * 
+ * Same blocking and parallelism as matrix_gemm, which it implements: no block of A
+ * larger than GEMM_MC x GEMM_KC, nor of B larger than GEMM_KC x GEMM_NC, is ever held
+ * as floats.
+ * 
+ * @param alpha scalar multiplying the product
+ * @param a left operand
+ * @param b right operand
+ * @param beta scalar multiplying c (ignored if c is NULL)
+ * @param c matrix to update, or NULL to return a new matrix
+ * @return Matrix* the updated or new matrix C
+ */
+Matrix *matrix_gemm_packed(float _Complex alpha, GemmOperand a, GemmOperand b, float _Complex beta, Matrix *c);
+
+/**
+ * @brief compute C = alpha op(A) op(B) + beta C with three real products per block
+ * 
+ * Gauss's 3M method: with A = Ar + i Ai and B = Br + i Bi, the real part of AB is
+ * Ar Br - Ai Bi and the imaginary part (Ar + Ai)(Br + Bi) - Ar Br - Ai Bi, i.e. 3 real
+ * products instead of 4, saving a quarter of the multiplications on complex operands.
+ * The real part is as accurate as with matrix_gemm, but the error on the imaginary
+ * part is bounded relative to |A| |B| rather than to the imaginary part itself, so it
+ * can lose relative accuracy when the imaginary part of the product is much smaller
+ * than its real part. Use matrix_gemm for real operands, which it detects.
+ * 
+ * @param alpha scalar multiplying the product
+ * @param a left operand
+ * @param b right operand
+ * @param beta scalar multiplying c (ignored if c is NULL)
+ * @param c matrix to update, or NULL to return a new matrix
+ * @return Matrix* the updated or new matrix C
+ */
+Matrix *matrix_gemm_3m(float _Complex alpha, MatrixView a, MatrixView b, float _Complex beta, Matrix *c);
+
+/**
+ * @brief compute y = alpha op(A) x + beta y, op being encoded in the view
+ * 
+ * For A, blocks of rows of y are computed in parallel, streaming four columns of A per
+ * pass; for A^T and A^H every element of y is a dot product with a column of A. Both
+ * read A exactly once, so the product runs at memory bandwidth.
+ * 
+ * @param alpha scalar multiplying the product
+ * @param a matrix
+ * @param x vector with as many rows as op(A) has columns
+ * @param beta scalar multiplying y (ignored if y is NULL)
+ * @param y vector to update, or NULL to return a new vector
+ * @return Vector* the updated or new vector y
+ */
+Vector *matrix_gemv(float _Complex alpha, MatrixView a, const Vector *x, float _Complex beta, Vector *y);
+
+/**
+ * @brief compute alpha op(A) x for each of several vectors x
+ * 
+ * The vectors are multiplied together as the columns of a matrix (without copying
+ * them), so that A is read once per block of vectors instead of once per vector.
+ * 
+ * @param alpha scalar multiplying the products
+ * @param a matrix
+ * @param xs array of vectors with as many rows as op(A) has columns
+ * @param count number of vectors
+ * @return Vector* array of count products, each to be freed with free_vector
+ */
+Vector *matrix_gemv_batched(float _Complex alpha, MatrixView a, const Vector *xs, int count);
+
+/**
+ * @brief Copy a block of a matrix m into a new matrix (init_matrix_view shares it instead)
  * 
  * @param m matrix
  * @param row_start starting row index
@@ -106,8 +306,30 @@ Matrix *matrix_mult(const Matrix *m1, const Matrix *m2);
 Matrix *create_submatrix(const Matrix *m, int row_start, int row_end, int col_start, int col_end);
 
 /**
- * @brief Helper function for fast matrix multiplication, wherein a submatrix is set
- * into a matrix m
+ * @brief make a matrix share a block of another one, without copying its elements
+ * 
+ * Only the column headers are allocated, each pointing into a column of m, so the view
+ * can be handed to any function taking a matrix and writes through it land in m. It
+ * must be removed with free_matrix_view and not outlive m.
+ * 
+ * @param view matrix to initialise
+ * @param m matrix to look into
+ * @param row_start starting row index
+ * @param row_end ending row index (excluded)
+ * @param col_start starting column index
+ * @param col_end ending column index (excluded)
+ */
+void init_matrix_view(Matrix *view, const Matrix *m, int row_start, int row_end, int col_start, int col_end);
+
+/**
+ * @brief remove the column headers of a matrix view, leaving the viewed matrix intact
+ * 
+ * @param view matrix view
+ */
+void free_matrix_view(Matrix *view);
+
+/**
+ * @brief Copy a matrix into a block of a matrix m
  * 
  * @param m matrix
  * @param sub submatrix to set
@@ -122,6 +344,10 @@ Matrix *set_submatrix(Matrix *m, const Matrix *sub, int row_start, int row_end,
 /**
  * @brief return the multiplication of two matrices together using Strassen's algorithm
  * 
+ * The seven products of each recursion level are spawned as tasks on the work-stealing
+ * scheduler, so nested levels are balanced across all workers without creating threads.
+ * Matrices that are not square with a power of 2 size are multiplied with matrix_mult.
+ * 
  * @param m1 first matrix
  * @param m2 second matrix
  * @return resultant matrix
@@ -131,12 +357,27 @@ Matrix *fast_matrix_mult(const Matrix *m1, const Matrix *m2);
 /**
  * @brief return the power of a matrix
  * 
- * @param m matrix
- * @param p power
+ * Exponentiation by squaring: O(log p) products, computed in three reused matrices.
+ * 
+ * @param m square matrix
+ * @param p non-negative power
  * @return Matrix* the matrix m multiplied by itself p times 
  */
 Matrix *matrix_power(const Matrix *m, int p);
 
+/**
+ * @brief return the product of the power of a matrix with a vector, without forming the power
+ * 
+ * Applies p matrix-vector products (O(p n^2) time), which is cheaper than matrix_power
+ * whenever p is smaller than about n log p.
+ * 
+ * @param m square matrix
+ * @param p non-negative power
+ * @param v vector
+ * @return Vector* m^p v
+ */
+Vector *matrix_power_vector(const Matrix *m, int p, const Vector *v);
+
 /**
  * @brief return the Hadamard product of two matrices (i.e. element-wise multiplication)
  * 
@@ -149,12 +390,28 @@ Matrix *matrix_hadamard_prod(const Matrix *m1, const Matrix *m2);
 /**
  * @brief return the Kronecker product of two matrices
  * 
+ * Every column of the result is built as scaled copies of a column of m2, columns
+ * being processed in parallel.
+ * 
  * @param m1 matrix 1
  * @param m2 matrix 2
- * @return Matrix*
+ * @return Matrix* the (rows1 * rows2) x (cols1 * cols2) matrix of the blocks m1(i, j) m2
  */
 Matrix *matrix_kronecker_prod(const Matrix *m1, const Matrix *m2);
 
+/**
+ * @brief apply the Kronecker product of two matrices to a vector without forming it
+ * 
+ * Uses (A (x) B) vec(X) = vec(B X A^T): two matrix products on the factors, i.e.
+ * O(N^1.5) time for an N x N product of square factors instead of O(N^2).
+ * 
+ * @param a first factor
+ * @param b second factor
+ * @param x vector of cols(a) * cols(b) elements
+ * @return Vector* (a (x) b) x
+ */
+Vector *kronecker_mult_vector(const Matrix *a, const Matrix *b, const Vector *x);
+
 /**
  * @brief return the tensor product of two vectors
  * 
@@ -167,6 +424,9 @@ Matrix *vector_tensor_prod(const Vector *u, const Vector *v);
 /**
  * @brief compute the transpose of a matrix
  * 
+ * Column strips are transposed in parallel, each by recursive halving down to tiles
+ * that are transposed 4x4 in SIMD registers.
+ * 
  * @param m matrix
  * @return Matrix* the original matrix the rows and columns of which are permuted 
  */
@@ -180,6 +440,14 @@ Matrix *matrix_transpose(const Matrix *m);
  */
 Matrix *matrix_conj_transpose(const Matrix *m);
 
+/**
+ * @brief transpose a square matrix in place, tile by tile
+ * 
+ * @param m square matrix
+ * @param conj conjugate the elements as well (conjugate transpose)
+ */
+void matrix_transpose_inplace(Matrix *m, bool conj);
+
 /**
  * @brief compute the cofactor matrix of a matrix
  * 
@@ -197,27 +465,27 @@ Matrix *matrix_cofactor(const Matrix *m);
 Matrix *matrix_adjoint(const Matrix *m);
 
 /**
- * @brief compute the inverse of a matrix
+ * @brief compute the inverse of a matrix from its LU factorization
  * 
  * @param m matrix
- * @return Matrix* the inverse of the matrix
+ * @return Matrix* the inverse of the matrix, or NULL if it is singular
  */
 Matrix *matrix_inverse(const Matrix *m);
 
 /**
- * @brief Compute the eigenvalues of a matrix
- * TODO: work on this + test
+ * @brief Compute the eigenvalues of a square matrix, with the Hermitian solver if the
+ * matrix is Hermitian (real eigenvalues in ascending order) and Hessenberg-QR otherwise
  * 
  * @param m matrix
- * @return Matrix* the collection of eigenvectors 
+ * @return Matrix* column of eigenvalues, or NULL if the iterations did not converge
  */
 Matrix *matrix_eigenvalues(const Matrix *m);
 
 /**
- * @brief Compute the determinant of a square matrix m
+ * @brief Compute the determinant of a square matrix m from its LU factorization
  * 
  * @param m matrix
- * @return int the value of the determinant
+ * @return float the (real part of the) value of the determinant
  */
 float matrix_determinant(const Matrix *m);
 
@@ -257,6 +525,15 @@ Matrix *matrix_rotate_right(const Matrix *m);
  */
 bool matrix_is_symmetric(const Matrix *m);
 
+/**
+ * @brief check if a matrix is Hermitian (equal to its conjugate transpose)
+ * 
+ * @param m matrix
+ * @return true if matrix is Hermitian
+ * @return false otherwise
+ */
+bool matrix_is_hermitian(const Matrix *m);
+
 /**
  * @brief check if a matrix is diagonal
  * 
@@ -296,6 +573,9 @@ bool matrix_is_real(Matrix *m);
 /**
  * @brief check if a matrix is stochastic
  * 
+ * All the line sums are accumulated in one pass over the columns, which stops at the
+ * first column holding a negative or complex element.
+ * 
  * @param m matrix
  * @return true if every line in m sums to 1
  * @return false otherwise
@@ -320,6 +600,54 @@ bool matrix_is_doubly_stochastic(Matrix *m);
  */
 bool matrix_is_vandermonde(Matrix *m);
 
+/**
+ * @brief test whether a matrix is symmetric by sampling O(1/epsilon) elements
+ * 
+ * One-sided error: symmetric matrices are always accepted, matrices that differ from
+ * every symmetric matrix in more than epsilon n^2 elements are rejected with
+ * probability at least 1 - e^-2.
+ * 
+ * @param m square matrix
+ * @param epsilon distance to the property, in (0, 1]
+ * @return true if no sampled element contradicts the property
+ * @return false if m is certainly not symmetric
+ */
+bool matrix_probably_symmetric(const Matrix *m, float epsilon);
+
+/**
+ * @brief test whether a matrix is diagonal by sampling O(1/epsilon) elements
+ * 
+ * @param m square matrix
+ * @param epsilon distance to the property, in (0, 1]
+ * @return true if no sampled element contradicts the property
+ * @return false if m is certainly not diagonal
+ */
+bool matrix_probably_diagonal(const Matrix *m, float epsilon);
+
+/**
+ * @brief test whether a matrix is stochastic by summing O(1/epsilon) sampled lines
+ * 
+ * Matrices more than an epsilon fraction of the lines of which do not sum to 1 are
+ * rejected with probability at least 1 - e^-2.
+ * 
+ * @param m matrix
+ * @param epsilon fraction of invalid lines, in (0, 1]
+ * @return true if every sampled line sums to 1
+ * @return false if m is certainly not stochastic
+ */
+bool matrix_probably_stochastic(const Matrix *m, float epsilon);
+
+/**
+ * @brief test whether a matrix is doubly stochastic by summing O(1/epsilon) sampled
+ * lines and columns
+ * 
+ * @param m matrix
+ * @param epsilon fraction of invalid lines or columns, in (0, 1]
+ * @return true if every sampled line and column sums to 1
+ * @return false if m is certainly not doubly stochastic
+ */
+bool matrix_probably_doubly_stochastic(const Matrix *m, float epsilon);
+
 // ################################# MATRIX NORMS ######################################
 
 /**
@@ -342,10 +670,31 @@ float matrix_Linf_norm(const Matrix *m);
  * @brief return the Frobenius norm of a given matrix
  * 
  * @param m matrix
- * @return float root of sum of squares
+ * @return float root of the sum of the squared magnitudes
  */
 float matrix_frobenius_norm(const Matrix *m);
 
+/**
+ * @brief compute the norms, absolute sums, trace, extreme magnitudes, realness and
+ * integrality of a matrix in a single pass
+ * 
+ * Chunks of columns are summarised in parallel, each with its own row sums, which are
+ * then reduced. The elements of a column are spread over STATS_LANES partial
+ * summaries, which lets the loop vectorise when square roots need not set errno
+ * (-fno-math-errno, as in the makefile).
+ * 
+ * @param m matrix
+ * @return MatrixStats* summary, to be freed with free_matrix_stats
+ */
+MatrixStats *matrix_stats(const Matrix *m);
+
+/**
+ * @brief remove the arrays of a matrix summary from memory
+ * 
+ * @param s summary
+ */
+void free_matrix_stats(MatrixStats *s);
+
 // ############################# MATRIX PRINTING #######################################
 
 /**
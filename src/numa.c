@@ -0,0 +1,150 @@
+#include "numa.h"
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef __linux__
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+// Modes of the mbind system call
+#define MPOL_BIND 2
+#define MPOL_INTERLEAVE 3
+
+static AllocPolicy alloc_policy = ALLOC_LOCAL;
+static int alloc_node = 0;
+// Whether a buffer could not be bound, reported once as every later failure would be
+// for the same reason
+static atomic_bool placement_failed = false;
+
+// ################################ MEMORY TOPOLOGY ####################################
+
+// Bit k set for every online node k < 64, read from a list such as "0-1,3"
+static unsigned long online_nodes(void) {
+    unsigned long mask = 0;
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+    if (f == NULL)
+        return 1;
+    int first, last;
+    char separator;
+    while (fscanf(f, "%d", &first) == 1) {
+        last = first;
+        separator = fgetc(f);
+        if (separator == '-') {
+            if (fscanf(f, "%d", &last) != 1)
+                break;
+            separator = fgetc(f);
+        }
+        for (int k = first; k <= last && k < 64; k++)
+            mask |= 1ul << k;
+        if (separator != ',')
+            break;
+    }
+    fclose(f);
+    return mask != 0 ? mask : 1;
+}
+
+int numa_node_count(void) {
+    return __builtin_popcountl(online_nodes());
+}
+
+// ############################## ALLOCATION POLICIES ##################################
+
+void set_alloc_policy(AllocPolicy policy, int node) {
+    assert(policy != ALLOC_NODE_BOUND || (node >= 0 && node < 64 && (online_nodes() >> node & 1)));
+    alloc_policy = policy;
+    alloc_node = node;
+}
+
+AllocPolicy get_alloc_policy(void) {
+    return alloc_policy;
+}
+
+bool alloc_policy_binds_pages(void) {
+#if defined(__linux__) && defined(SYS_mbind)
+    return alloc_policy == ALLOC_INTERLEAVED || alloc_policy == ALLOC_NODE_BOUND;
+#else
+    return false;
+#endif
+}
+
+int place_buffer(void *p, size_t bytes) {
+    if (alloc_policy != ALLOC_INTERLEAVED && alloc_policy != ALLOC_NODE_BOUND)
+        return 0;
+#if defined(__linux__) && defined(SYS_mbind)
+    // Only the pages lying entirely within the buffer, which it does not share
+    size_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t start = ((uintptr_t) p + page - 1) & ~(page - 1);
+    uintptr_t end = ((uintptr_t) p + bytes) & ~(page - 1);
+    if (end <= start)
+        return 0;
+    unsigned long mask = alloc_policy == ALLOC_NODE_BOUND ? 1ul << alloc_node : online_nodes();
+    int mode = alloc_policy == ALLOC_NODE_BOUND ? MPOL_BIND : MPOL_INTERLEAVE;
+    // The kernel reads maxnode - 1 bits of the mask
+    if (syscall(SYS_mbind, start, end - start, mode, &mask, 8 * sizeof mask + 1, 0) != 0)
+        return -1;
+    return 0;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+// Size of the whole pages holding a buffer
+static size_t mapped_size(size_t bytes) {
+#ifdef __linux__
+    size_t page = sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) & ~(page - 1);
+#else
+    return bytes;
+#endif
+}
+
+void *map_buffer(size_t bytes) {
+#ifdef __linux__
+    void *p = mmap(NULL, mapped_size(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return NULL;
+    if (place_buffer(p, mapped_size(bytes)) != 0 && !atomic_exchange(&placement_failed, true))
+        perror("place_buffer failed, leaving pages to the first thread touching them");
+    return p;
+#else
+    (void) bytes;
+    errno = ENOSYS;
+    return NULL;
+#endif
+}
+
+void unmap_buffer(void *p, size_t bytes) {
+#ifdef __linux__
+    munmap(p, mapped_size(bytes));
+#else
+    (void) p;
+    (void) bytes;
+#endif
+}
+
+typedef struct ZeroFill {
+    char *p;
+    size_t count;
+    size_t size;
+} ZeroFill;
+
+static void zero_blocks(int start, int end, void *arg) {
+    const ZeroFill *z = arg;
+    size_t first = (size_t) start * FIRST_TOUCH_ROW_BLOCK;
+    size_t last = min((size_t) end * FIRST_TOUCH_ROW_BLOCK, z->count);
+    memset(z->p + first * z->size, 0, (last - first) * z->size);
+}
+
+void zero_fill(void *p, size_t count, size_t size) {
+    if (alloc_policy == ALLOC_LOCAL || count <= FIRST_TOUCH_ROW_BLOCK) {
+        memset(p, 0, count * size);
+        return;
+    }
+    ZeroFill z = {p, count, size};
+    int blocks = (count + FIRST_TOUCH_ROW_BLOCK - 1) / FIRST_TOUCH_ROW_BLOCK;
+    parallel_for(0, blocks, 1, zero_blocks, &z);
+}
@@ -0,0 +1,101 @@
+#ifndef NUMA_HEADER
+#define NUMA_HEADER
+
+#include "scheduler.h"
+#include <stddef.h>
+
+// Placement of the pages of the buffers allocated by init_vector, and thus by
+// init_matrix and init_tensor, on machines with several memory nodes. A page lands on
+// the node of the thread that first writes to it unless a policy is bound to it.
+typedef enum AllocPolicy {
+    ALLOC_LOCAL,        // zero-filled by the allocating thread, so all on its node
+    ALLOC_FIRST_TOUCH,  // zero-filled in parallel, with the partitioning of the kernels
+    ALLOC_INTERLEAVED,  // spread page by page over every node
+    ALLOC_NODE_BOUND    // bound to a single node
+} AllocPolicy;
+
+// Elements of a vector zero-filled by a single task, as the row blocks of the GEMV
+#define FIRST_TOUCH_ROW_BLOCK 2048
+
+/**
+ * @brief choose where the pages of the buffers allocated from now on are placed
+ *
+ * The policy is global and should be set while no buffer is being allocated. Binding
+ * pages to nodes relies on the mbind system call, and is a no-op where it is not
+ * available; where it is, the buffers allocated under a binding policy are mapped on
+ * whole pages of their own (see map_buffer). The zero-fill of the buffers runs in
+ * parallel under every policy but ALLOC_LOCAL.
+ *
+ * @param policy placement policy
+ * @param node node of ALLOC_NODE_BOUND (ignored by the other policies)
+ */
+void set_alloc_policy(AllocPolicy policy, int node);
+
+/**
+ * @brief get the current placement policy
+ *
+ * @return AllocPolicy placement policy
+ */
+AllocPolicy get_alloc_policy(void);
+
+/**
+ * @brief get the number of online memory nodes
+ *
+ * @return int number of nodes (1 if the topology cannot be read)
+ */
+int numa_node_count(void);
+
+/**
+ * @brief tell whether buffers must be mapped by map_buffer to follow the current
+ * policy, i.e. whether it binds pages and binding is available
+ *
+ * @return bool true under ALLOC_INTERLEAVED and ALLOC_NODE_BOUND where mbind exists
+ */
+bool alloc_policy_binds_pages(void);
+
+/**
+ * @brief bind the whole pages of a freshly allocated buffer to the current policy
+ *
+ * Must be called before the buffer is first written to, pages placed by an earlier
+ * write being left where they are. The policy stays attached to the pages until they
+ * are unmapped, so the buffer should own them, as those of map_buffer do.
+ *
+ * @param p buffer
+ * @param bytes size of the buffer
+ * @return int 0 on success, -1 with errno set if the pages could not be bound
+ */
+int place_buffer(void *p, size_t bytes);
+
+/**
+ * @brief map a buffer on whole pages of its own, bound to the current policy
+ *
+ * Adjacent buffers bound to the same policy share one memory mapping of the kernel,
+ * and unmap_buffer removes the policy with the pages. If the pages cannot be bound,
+ * which is reported on stderr the first time, they are left to first touch.
+ *
+ * @param bytes size of the buffer
+ * @return void* page-aligned buffer, or NULL with errno set if it could not be mapped
+ */
+void *map_buffer(size_t bytes);
+
+/**
+ * @brief unmap a buffer of map_buffer
+ *
+ * @param p buffer
+ * @param bytes size it was mapped with
+ */
+void unmap_buffer(void *p, size_t bytes);
+
+/**
+ * @brief zero-fill a buffer according to the current policy
+ *
+ * Under ALLOC_LOCAL the calling thread writes the whole buffer; otherwise blocks of
+ * FIRST_TOUCH_ROW_BLOCK elements are written by parallel tasks.
+ *
+ * @param p buffer
+ * @param count number of elements
+ * @param size size of an element
+ */
+void zero_fill(void *p, size_t count, size_t size);
+
+#endif
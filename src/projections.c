@@ -56,8 +56,7 @@ float *generate_gaussian_random_variables(int num_variables) {
     for (int i = 0; i < num_variables; i++) {
         float U1 = generate_uniform_probability();
         float U2 = generate_uniform_probability();
-        float Z = sqrt(-2*log(U1)) * cos(2*M_PI*U2);
-        *(rvs + i) = Z; // equivalent to rvs[i] = Z;
+        *(rvs + i) = box_muller(U1, U2); // equivalent to rvs[i] = box_muller(U1, U2);
     }
     return rvs;
 }
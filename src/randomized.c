@@ -0,0 +1,363 @@
+#include "randomized.h"
+#include "kernels.h"
+#include <string.h>
+
+// ################################ RANDOM SAMPLING ####################################
+
+int *sample_with_replacement(const float *weights, int n, int count) {
+    assert(n > 0 && count >= 0);
+    double *cdf = malloc(n * sizeof *cdf);
+    double total = 0.0;
+    for (int k = 0; k < n; k++) {
+        assert(weights[k] >= 0.0f);
+        total += weights[k];
+        cdf[k] = total;
+    }
+    assert(total > 0.0);
+
+    int *samples = malloc(max(count, 1) * sizeof *samples);
+    for (int t = 0; t < count; t++) {
+        double u = (rand() + 0.5) / (RAND_MAX + 1.0) * total;
+        // First index whose cumulative weight exceeds u, which skips zero weights
+        int lo = 0, hi = n - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] > u)
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        samples[t] = lo;
+    }
+    free(cdf);
+    return samples;
+}
+
+// ########################## APPROXIMATE MATRIX MULTIPLICATION ########################
+
+int approximate_mult_samples(float epsilon, float delta) {
+    assert(epsilon > 0.0f && delta > 0.0f && delta < 1.0f);
+    float eta = 1.0f + sqrtf(8.0f * logf(1.0f / delta));
+    return (int) ceilf(eta * eta / (epsilon * epsilon));
+}
+
+Matrix *approximate_matrix_mult(const Matrix *a, const Matrix *b, float epsilon, float delta, float *error) {
+    assert(a->cols == b->rows);
+    int n = a->cols;
+    int c = approximate_mult_samples(epsilon, delta);
+    if (error != NULL)
+        *error = 0.0f;
+    if (c >= n)
+        return matrix_mult(a, b);
+
+    // Optimal probabilities p_k = ||A_:k|| ||B_k:|| / sum of the same products
+    float *weights = calloc(n, sizeof *weights);
+    for (int j = 0; j < b->cols; j++)
+        for (int k = 0; k < n; k++) {
+            float re = crealf(b->items[j].items[k]), im = cimagf(b->items[j].items[k]);
+            weights[k] += re * re + im * im;
+        }
+    float total = 0.0f;
+    for (int k = 0; k < n; k++) {
+        weights[k] = vector_L2_norm(a->items + k) * sqrtf(weights[k]);
+        total += weights[k];
+    }
+    if (total == 0.0f) {
+        free(weights);
+        Matrix *m = malloc(sizeof(Matrix));
+        init_matrix(m, "M", a->rows, b->cols);
+        return m;
+    }
+
+    // A pair drawn n_k times contributes n_k / (c p_k) A_:k B_k:, so repeated draws
+    // are merged into a single column of C and row of R
+    int *samples = sample_with_replacement(weights, n, c);
+    int *counts = calloc(n, sizeof *counts);
+    for (int t = 0; t < c; t++)
+        counts[samples[t]]++;
+    int distinct = 0;
+    for (int k = 0; k < n; k++)
+        if (counts[k] > 0)
+            samples[distinct++] = k;
+
+    Matrix *cs = malloc(sizeof(Matrix)), *rs = malloc(sizeof(Matrix));
+    init_matrix(cs, "C", a->rows, distinct);
+    init_matrix(rs, "R", distinct, b->cols);
+    for (int s = 0; s < distinct; s++) {
+        int k = samples[s];
+        memcpy(cs->items[s].items, a->items[k].items, a->rows * sizeof *a->items[k].items);
+        complex_scal(a->rows, counts[k] * total / (c * weights[k]), cs->items[s].items);
+    }
+    for (int j = 0; j < b->cols; j++)
+        for (int s = 0; s < distinct; s++)
+            rs->items[j].items[s] = b->items[j].items[samples[s]];
+    Matrix *m = matrix_gemm(1.0f, view_of(cs), view_of(rs), 0.0f, NULL);
+
+    // E ||AB - CR||_F^2 <= (sum_k ||A_:k|| ||B_k:||)^2 / c
+    if (error != NULL)
+        *error = total / sqrtf(c);
+
+    free_matrix(cs);
+    free_matrix(rs);
+    free(cs);
+    free(rs);
+    free(weights);
+    free(samples);
+    free(counts);
+    return m;
+}
+
+// ############################### TRACE ESTIMATION ####################################
+
+// Mean of the probe values z_i, with the standard error given by their spread
+static Estimate mean_estimate(const float _Complex *z, int k) {
+    float _Complex mean = 0.0f;
+    for (int i = 0; i < k; i++)
+        mean += z[i];
+    mean /= k;
+    float variance = 0.0f;
+    for (int i = 0; i < k; i++) {
+        float _Complex d = z[i] - mean;
+        variance += crealf(d) * crealf(d) + cimagf(d) * cimagf(d);
+    }
+    float std_error = k > 1 ? sqrtf(variance / (k - 1) / k) : INFINITY;
+    return (Estimate) {mean, std_error};
+}
+
+// From an estimate of ||A||_F^2 to one of ||A||_F, the error being propagated linearly
+static Estimate square_root_estimate(Estimate e) {
+    float norm = sqrtf(fmaxf(crealf(e.value), 0.0f));
+    return (Estimate) {norm, norm > 0.0f ? e.std_error / (2.0f * norm) : e.std_error};
+}
+
+void dense_matvec(const Vector *x, Vector *y, void *arg) {
+    matrix_gemv(1.0f, view_of(arg), x, 0.0f, y);
+}
+
+Estimate hutchinson_trace(matvec_func matvec, void *arg, int n, int probes) {
+    assert(n > 0 && probes > 0);
+    float _Complex *z = malloc(probes * sizeof *z);
+    Vector y;
+    init_vector(&y, "y", n);
+    for (int i = 0; i < probes; i++) {
+        Vector *g = rademacher_vector(n);
+        matvec(g, &y, arg);
+        z[i] = complex_dotc(n, g->items, y.items);
+        free_vector(g);
+        free(g);
+    }
+    Estimate e = mean_estimate(z, probes);
+    free_vector(&y);
+    free(z);
+    return e;
+}
+
+Estimate hutchpp_trace(matvec_func matvec, void *arg, int n, int probes) {
+    int k = probes / 3;
+    assert(k > 0 && k <= n);
+
+    // Orthonormal basis Q of the range of A S, S being a Rademacher sketch
+    Matrix *s = rademacher_matrix(n, k);
+    Matrix *y = malloc(sizeof(Matrix));
+    init_matrix(y, "Y", n, k);
+    for (int j = 0; j < k; j++)
+        matvec(s->items + j, y->items + j, arg);
+    QR *f = qr_factorize_inplace(y);
+    Matrix *q = qr_q(f);
+    free_qr(f);
+    free(f);
+
+    // Exact trace of Q^H A Q
+    float _Complex trace = 0.0f;
+    Vector ay;
+    init_vector(&ay, "y", n);
+    for (int j = 0; j < k; j++) {
+        matvec(q->items + j, &ay, arg);
+        trace += complex_dotc(n, q->items[j].items, ay.items);
+    }
+
+    // Hutchinson's estimator on the complement of the range: with P = I - QQ^H,
+    // g^H P A P g = (P g)^H A (P g)
+    float _Complex *z = malloc(k * sizeof *z);
+    for (int i = 0; i < k; i++) {
+        Vector *g = rademacher_vector(n);
+        Vector *c = matrix_gemv(1.0f, view_conj_transpose(q), g, 0.0f, NULL);
+        matrix_gemv(-1.0f, view_of(q), c, 1.0f, g);
+        matvec(g, &ay, arg);
+        z[i] = complex_dotc(n, g->items, ay.items);
+        free_vector(g);
+        free_vector(c);
+        free(g);
+        free(c);
+    }
+    Estimate e = mean_estimate(z, k);
+    e.value += trace;
+
+    free_matrix(s);
+    free_matrix(y);
+    free_matrix(q);
+    free_vector(&ay);
+    free(s);
+    free(y);
+    free(q);
+    free(z);
+    return e;
+}
+
+// ############################## NORM ESTIMATION ######################################
+
+Estimate matrix_frobenius_estimate(const Matrix *m, int samples) {
+    assert(samples > 0);
+    if (samples >= m->cols) {
+        float norm = 0.0f;
+        for (int j = 0; j < m->cols; j++) {
+            float column = vector_L2_norm(m->items + j);
+            norm += column * column;
+        }
+        return (Estimate) {sqrtf(norm), 0.0f};
+    }
+
+    // ||A||_F^2 = cols * E ||A_:j||^2 for a uniformly random column j
+    float _Complex *z = malloc(samples * sizeof *z);
+    for (int i = 0; i < samples; i++) {
+        float column = vector_L2_norm(m->items + rand() % m->cols);
+        z[i] = (float) m->cols * column * column;
+    }
+    Estimate e = square_root_estimate(mean_estimate(z, samples));
+    free(z);
+    return e;
+}
+
+Estimate operator_frobenius_estimate(matvec_func matvec, void *arg, int rows, int cols, int probes) {
+    assert(rows > 0 && cols > 0 && probes > 0);
+    float _Complex *z = malloc(probes * sizeof *z);
+    Vector y;
+    init_vector(&y, "y", rows);
+    for (int i = 0; i < probes; i++) {
+        Vector *g = rademacher_vector(cols);
+        matvec(g, &y, arg);
+        float norm = vector_L2_norm(&y);
+        z[i] = norm * norm;
+        free_vector(g);
+        free(g);
+    }
+    Estimate e = square_root_estimate(mean_estimate(z, probes));
+    free_vector(&y);
+    free(z);
+    return e;
+}
+
+float spectral_norm_power(const Matrix *m, float tolerance, int max_iterations) {
+    assert(max_iterations > 0);
+    Vector *x = rademacher_vector(m->cols);
+    Vector y;
+    init_vector(&y, "y", m->rows);
+    complex_scal(m->cols, 1.0f / vector_L2_norm(x), x->items);
+
+    float sigma = 0.0f;
+    for (int it = 0; it < max_iterations; it++) {
+        // sigma = ||A x|| for the unit vector x, then x <- A^H A x / ||A^H A x||
+        matrix_gemv(1.0f, view_of(m), x, 0.0f, &y);
+        float previous = sigma;
+        sigma = vector_L2_norm(&y);
+        matrix_gemv(1.0f, view_conj_transpose(m), &y, 0.0f, x);
+        float norm = vector_L2_norm(x);
+        if (norm == 0.0f || fabsf(sigma - previous) <= tolerance * sigma)
+            break;
+        complex_scal(m->cols, 1.0f / norm, x->items);
+    }
+    free_vector(x);
+    free_vector(&y);
+    free(x);
+    return sigma;
+}
+
+// Orthogonalise w against the first k columns of q and return its norm. In single
+// precision one Gram-Schmidt pass leaves components large enough to corrupt the
+// smallest Ritz values, two passes are enough.
+static float reorthogonalize(Vector *w, const Matrix *q, int k) {
+    for (int pass = 0; pass < 2; pass++)
+        for (int j = 0; j < k; j++)
+            complex_axpy(w->capacity, -complex_dotc(w->capacity, q->items[j].items, w->items), q->items[j].items, w->items);
+    return vector_L2_norm(w);
+}
+
+// Extreme singular values of the upper bidiagonal matrix with diagonal alpha and
+// superdiagonal beta
+static void bidiagonal_extremes(const float *alpha, const float *beta, int k, float *largest, float *smallest) {
+    Matrix b;
+    init_matrix(&b, "B", k, k);
+    for (int j = 0; j < k; j++) {
+        b.items[j].items[j] = alpha[j];
+        if (j > 0)
+            b.items[j].items[j-1] = beta[j-1];
+    }
+    SVD *f = matrix_svd(&b);
+    *largest = crealf(f->s->items[0]);
+    *smallest = crealf(f->s->items[k-1]);
+    free_svd(f);
+    free_matrix(&b);
+    free(f);
+}
+
+// Golub-Kahan-Lanczos bidiagonalization A V = U B of the tall orientation of m,
+// stopped once the requested extreme singular values of B settle
+static void lanczos_extremes(const Matrix *m, float tolerance, int max_iterations, bool smallest, float *sigma_max, float *sigma_min) {
+    bool tall = m->rows >= m->cols;
+    MatrixView a = tall ? view_of(m) : view_conj_transpose(m);
+    MatrixView ah = tall ? view_conj_transpose(m) : view_of(m);
+    int rows = max(m->rows, m->cols), cols = min(m->rows, m->cols);
+    int steps = min(max_iterations, cols);
+    assert(steps > 0);
+
+    Matrix u, v;
+    init_matrix(&u, "U", rows, steps);
+    init_matrix(&v, "V", cols, steps);
+    float *alpha = malloc(steps * sizeof *alpha), *beta = malloc(steps * sizeof *beta);
+
+    Vector *start = rademacher_vector(cols);
+    complex_axpy(cols, 1.0f / vector_L2_norm(start), start->items, v.items[0].items);
+    free_vector(start);
+    free(start);
+
+    *sigma_max = *sigma_min = 0.0f;
+    for (int k = 0; k < steps; k++) {
+        // alpha_k u_k = A v_k - beta_(k-1) u_(k-1)
+        matrix_gemv(1.0f, a, v.items + k, 0.0f, u.items + k);
+        alpha[k] = reorthogonalize(u.items + k, &u, k);
+        if (alpha[k] > 0.0f)
+            complex_scal(rows, 1.0f / alpha[k], u.items[k].items);
+
+        float previous_max = *sigma_max, previous_min = *sigma_min;
+        bidiagonal_extremes(alpha, beta, k + 1, sigma_max, sigma_min);
+        bool settled = fabsf(*sigma_max - previous_max) <= tolerance * *sigma_max;
+        if (smallest)
+            settled = settled && fabsf(*sigma_min - previous_min) <= tolerance * *sigma_min;
+        if (k + 1 == steps || alpha[k] == 0.0f || (k > 0 && settled))
+            break;
+
+        // beta_k v_(k+1) = A^H u_k - alpha_k v_k
+        matrix_gemv(1.0f, ah, u.items + k, 0.0f, v.items + k + 1);
+        beta[k] = reorthogonalize(v.items + k + 1, &v, k + 1);
+        // An invariant subspace was found: the singular values of B are exact
+        if (beta[k] == 0.0f)
+            break;
+        complex_scal(cols, 1.0f / beta[k], v.items[k+1].items);
+    }
+    free_matrix(&u);
+    free_matrix(&v);
+    free(alpha);
+    free(beta);
+}
+
+float spectral_norm_lanczos(const Matrix *m, float tolerance, int max_iterations) {
+    float sigma_max, sigma_min;
+    lanczos_extremes(m, tolerance, max_iterations, false, &sigma_max, &sigma_min);
+    return sigma_max;
+}
+
+float condition_number_lanczos(const Matrix *m, float tolerance, int max_iterations) {
+    float sigma_max, sigma_min;
+    lanczos_extremes(m, tolerance, max_iterations, true, &sigma_max, &sigma_min);
+    return sigma_min > 0.0f ? sigma_max / sigma_min : INFINITY;
+}
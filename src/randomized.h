@@ -0,0 +1,171 @@
+#ifndef RANDOMIZED_HEADER
+#define RANDOMIZED_HEADER
+
+#include "svd.h"
+
+// Linear operator known only through its action: overwrite y with A x
+typedef void (*matvec_func)(const Vector *x, Vector *y, void *arg);
+
+// Randomized estimate. The spread of the probes gives its standard error, so that
+// value +/- 1.96 std_error is an approximate 95% confidence interval.
+typedef struct Estimate {
+    float _Complex value;
+    float std_error;    // infinite if a single probe was drawn
+} Estimate;
+
+// ################################ RANDOM SAMPLING ####################################
+
+/**
+ * @brief draw indices independently with probability proportional to their weight
+ *
+ * @param weights non-negative weights, not all zero
+ * @param n number of weights
+ * @param count number of indices to draw
+ * @return int* count indices in [0, n), drawn with replacement
+ */
+int *sample_with_replacement(const float *weights, int n, int count);
+
+// ########################## APPROXIMATE MATRIX MULTIPLICATION ########################
+
+/**
+ * @brief number of samples needed by approximate_matrix_mult for a given accuracy
+ *
+ * With c >= (1 + sqrt(8 ln(1/delta)))^2 / epsilon^2 samples, the approximation error
+ * is at most epsilon ||A||_F ||B||_F with probability at least 1 - delta.
+ *
+ * @param epsilon relative error
+ * @param delta failure probability
+ * @return int number of sampled column/row pairs
+ */
+int approximate_mult_samples(float epsilon, float delta);
+
+/**
+ * @brief approximate the product of two matrices by sampling column/row pairs
+ *
+ * Column k of A and row k of B are sampled with probability proportional to
+ * ||A_:k|| ||B_k:||, the sampled outer products being rescaled so that the estimate is
+ * unbiased (Drineas, Kannan and Mahoney). Runs in O(c * rows(A) * cols(B)) time after
+ * one pass over both matrices. The product is computed exactly if c is at least the
+ * inner dimension.
+ *
+ * @param a first matrix
+ * @param b second matrix
+ * @param epsilon relative error, in the sense of approximate_mult_samples
+ * @param delta failure probability
+ * @param error if not NULL, set to a bound on the root-mean-square Frobenius error
+ * @return Matrix* approximation of AB
+ */
+Matrix *approximate_matrix_mult(const Matrix *a, const Matrix *b, float epsilon, float delta, float *error);
+
+// ############################### TRACE ESTIMATION ####################################
+
+/**
+ * @brief matvec_func computing the product with an explicit matrix
+ *
+ * @param x vector
+ * @param y vector overwritten with A x
+ * @param arg the matrix A
+ */
+void dense_matvec(const Vector *x, Vector *y, void *arg);
+
+/**
+ * @brief estimate the trace of an n x n operator with Hutchinson's estimator
+ *
+ * Averages g^H A g over Rademacher probe vectors g, whose expectation is tr(A). The
+ * standard error decreases as 1 / sqrt(probes).
+ *
+ * @param matvec product with the operator
+ * @param arg argument passed to matvec
+ * @param n dimension of the operator
+ * @param probes number of products with the operator
+ * @return Estimate estimate of tr(A)
+ */
+Estimate hutchinson_trace(matvec_func matvec, void *arg, int n, int probes);
+
+/**
+ * @brief estimate the trace of an n x n operator with the Hutch++ estimator
+ *
+ * A third of the products sketch the range of A, the trace of which is computed
+ * exactly on an orthonormal basis Q; Hutchinson's estimator is only applied to the
+ * deflated (I - QQ^H) A (I - QQ^H). For matrices with decaying spectra the error
+ * decreases as 1 / probes instead of 1 / sqrt(probes).
+ *
+ * @param matvec product with the operator
+ * @param arg argument passed to matvec
+ * @param n dimension of the operator
+ * @param probes number of products with the operator (at least 3, at most 3n)
+ * @return Estimate estimate of tr(A)
+ */
+Estimate hutchpp_trace(matvec_func matvec, void *arg, int n, int probes);
+
+// ############################## NORM ESTIMATION ######################################
+
+/**
+ * @brief estimate the Frobenius norm of a matrix from a uniform sample of its columns
+ *
+ * Reads samples columns only, i.e. O(samples * rows) time. The norm is computed
+ * exactly if samples is at least the number of columns.
+ *
+ * @param m matrix
+ * @param samples number of columns drawn, with replacement
+ * @return Estimate estimate of ||m||_F
+ */
+Estimate matrix_frobenius_estimate(const Matrix *m, int samples);
+
+/**
+ * @brief estimate the Frobenius norm of an operator from its products with probes
+ *
+ * ||A||_F^2 is the expectation of ||A g||^2 over Rademacher vectors g.
+ *
+ * @param matvec product with the operator
+ * @param arg argument passed to matvec
+ * @param rows number of rows of the operator
+ * @param cols number of columns of the operator
+ * @param probes number of products with the operator
+ * @return Estimate estimate of ||A||_F
+ */
+Estimate operator_frobenius_estimate(matvec_func matvec, void *arg, int rows, int cols, int probes);
+
+/**
+ * @brief estimate the spectral norm ||A||_2 of a matrix by power iteration
+ *
+ * Iterates x <- A^H A x from a random start, with two GEMVs per iteration, until the
+ * estimate changes by less than a relative tolerance. The estimate never exceeds the
+ * norm, and converges as (sigma_2 / sigma_1)^(2 * iterations).
+ *
+ * @param m matrix
+ * @param tolerance relative change below which the iteration stops
+ * @param max_iterations maximum number of iterations
+ * @return float estimate of the largest singular value
+ */
+float spectral_norm_power(const Matrix *m, float tolerance, int max_iterations);
+
+/**
+ * @brief estimate the spectral norm ||A||_2 of a matrix by Lanczos bidiagonalization
+ *
+ * Golub-Kahan-Lanczos iterations, with full reorthogonalisation, build a small
+ * bidiagonal matrix whose largest singular value approximates that of A, usually in
+ * far fewer GEMVs than the power iteration.
+ *
+ * @param m matrix
+ * @param tolerance relative change below which the iteration stops
+ * @param max_iterations maximum number of Lanczos steps
+ * @return float estimate of the largest singular value
+ */
+float spectral_norm_lanczos(const Matrix *m, float tolerance, int max_iterations);
+
+/**
+ * @brief estimate the 2-norm condition number sigma_max / sigma_min of a matrix
+ *
+ * Uses both extreme singular values of the Lanczos bidiagonal matrix. The smallest
+ * one converges more slowly and from above, so the estimate is a lower bound of the
+ * condition number until min(rows, cols) steps are taken, where it becomes exact.
+ *
+ * @param m matrix
+ * @param tolerance relative change below which the iteration stops
+ * @param max_iterations maximum number of Lanczos steps
+ * @return float estimate of the condition number (infinite for a singular matrix)
+ */
+float condition_number_lanczos(const Matrix *m, float tolerance, int max_iterations);
+
+#endif
@@ -0,0 +1,246 @@
+#include "scheduler.h"
+#include <sched.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define SPIN_ROUNDS 64
+
+// Deque of a worker: the owner pushes and pops at the bottom, thieves steal at the top
+typedef struct Deque {
+    pthread_mutex_t lock;
+    atomic_int top;
+    atomic_int bottom;
+    Task tasks[DEQUE_CAPACITY];
+} Deque;
+
+static Deque deques[MAX_WORKERS];
+static pthread_t workers[MAX_WORKERS];
+static int num_workers = 0;
+static atomic_bool started = false;
+static atomic_bool stopping = false;
+static pthread_mutex_t start_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Idle workers sleep until a task is queued
+static atomic_int queued = 0;
+static atomic_int sleeping = 0;
+static pthread_mutex_t idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t idle_cond = PTHREAD_COND_INITIALIZER;
+
+// Threads that are not workers of the scheduler share deque 0
+static __thread int worker_id = 0;
+
+// ################################# DEQUE OPERATIONS ##################################
+
+static bool deque_push(Deque *d, Task t) {
+    pthread_mutex_lock(&d->lock);
+    bool pushed = d->bottom - d->top < DEQUE_CAPACITY;
+    if (pushed) {
+        d->tasks[d->bottom % DEQUE_CAPACITY] = t;
+        d->bottom++;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return pushed;
+}
+
+static bool deque_pop(Deque *d, Task *t) {
+    pthread_mutex_lock(&d->lock);
+    bool popped = d->bottom > d->top;
+    if (popped) {
+        d->bottom--;
+        *t = d->tasks[d->bottom % DEQUE_CAPACITY];
+    }
+    pthread_mutex_unlock(&d->lock);
+    return popped;
+}
+
+static bool deque_steal(Deque *d, Task *t) {
+    // Cheap unlocked check so that thieves do not contend on empty deques
+    if (atomic_load_explicit(&d->bottom, memory_order_relaxed) <= atomic_load_explicit(&d->top, memory_order_relaxed))
+        return false;
+    pthread_mutex_lock(&d->lock);
+    bool stolen = d->bottom > d->top;
+    if (stolen) {
+        *t = d->tasks[d->top % DEQUE_CAPACITY];
+        d->top++;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return stolen;
+}
+
+// ################################ TASK EXECUTION #####################################
+
+static bool find_task(int id, Task *t) {
+    if (deque_pop(&deques[id], t))
+        return true;
+    for (int k = 1; k < num_workers; k++)
+        if (deque_steal(&deques[(id + k) % num_workers], t))
+            return true;
+    return false;
+}
+
+static void run_task(Task t) {
+    atomic_fetch_sub(&queued, 1);
+    t.func(t.arg);
+    atomic_fetch_sub(&t.group->pending, 1);
+}
+
+static void *worker_loop(void *arg) {
+    worker_id = (int)(intptr_t) arg;
+    int idle_rounds = 0;
+    Task t;
+    while (!atomic_load(&stopping)) {
+        if (find_task(worker_id, &t)) {
+            run_task(t);
+            idle_rounds = 0;
+        } else if (++idle_rounds < SPIN_ROUNDS) {
+            sched_yield();
+        } else {
+            pthread_mutex_lock(&idle_lock);
+            atomic_fetch_add(&sleeping, 1);
+            while (atomic_load(&queued) == 0 && !atomic_load(&stopping))
+                pthread_cond_wait(&idle_cond, &idle_lock);
+            atomic_fetch_sub(&sleeping, 1);
+            pthread_mutex_unlock(&idle_lock);
+            idle_rounds = 0;
+        }
+    }
+    return NULL;
+}
+
+// ############################## SCHEDULER LIFECYCLE ##################################
+
+__attribute__((cold))
+void scheduler_init(int n) {
+    pthread_mutex_lock(&start_lock);
+    if (atomic_load(&started)) {
+        pthread_mutex_unlock(&start_lock);
+        return;
+    }
+    if (n <= 0)
+        n = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    num_workers = n < 1 ? 1 : (n > MAX_WORKERS ? MAX_WORKERS : n);
+
+    atomic_store(&stopping, false);
+    for (int i = 0; i < num_workers; i++) {
+        pthread_mutex_init(&deques[i].lock, NULL);
+        atomic_init(&deques[i].top, 0);
+        atomic_init(&deques[i].bottom, 0);
+    }
+    // Worker 0 is the thread that waits on task groups
+    for (int i = 1; i < num_workers; i++) {
+        if (pthread_create(&workers[i], NULL, worker_loop, (void *)(intptr_t) i) != 0) {
+            perror("pthread_create failed");
+            num_workers = i;
+            break;
+        }
+    }
+    atomic_store(&started, true);
+    pthread_mutex_unlock(&start_lock);
+}
+
+__attribute__((cold))
+void scheduler_shutdown(void) {
+    pthread_mutex_lock(&start_lock);
+    if (!atomic_load(&started)) {
+        pthread_mutex_unlock(&start_lock);
+        return;
+    }
+    pthread_mutex_lock(&idle_lock);
+    atomic_store(&stopping, true);
+    pthread_cond_broadcast(&idle_cond);
+    pthread_mutex_unlock(&idle_lock);
+
+    for (int i = 1; i < num_workers; i++)
+        pthread_join(workers[i], NULL);
+    for (int i = 0; i < num_workers; i++)
+        pthread_mutex_destroy(&deques[i].lock);
+    atomic_store(&started, false);
+    pthread_mutex_unlock(&start_lock);
+}
+
+int scheduler_num_workers(void) {
+    if (!atomic_load(&started))
+        scheduler_init(0);
+    return num_workers;
+}
+
+// ################################ TASK PRIMITIVES ####################################
+
+void init_task_group(TaskGroup *g) {
+    atomic_init(&g->pending, 0);
+}
+
+void task_spawn(TaskGroup *g, task_func func, void *arg) {
+    if (!atomic_load(&started))
+        scheduler_init(0);
+
+    Task t = {func, arg, g};
+    atomic_fetch_add(&g->pending, 1);
+    atomic_fetch_add(&queued, 1);
+    if (!deque_push(&deques[worker_id], t)) {
+        // The deque is full: run the task right away rather than failing
+        run_task(t);
+        return;
+    }
+
+    if (atomic_load(&sleeping) > 0) {
+        pthread_mutex_lock(&idle_lock);
+        pthread_cond_signal(&idle_cond);
+        pthread_mutex_unlock(&idle_lock);
+    }
+}
+
+void task_sync(TaskGroup *g) {
+    Task t;
+    while (atomic_load(&g->pending) > 0) {
+        if (find_task(worker_id, &t))
+            run_task(t);
+        else
+            sched_yield();
+    }
+}
+
+// ################################ PARALLEL LOOPS #####################################
+
+typedef struct RangeTask {
+    int start, end, grain;
+    range_func func;
+    void *arg;
+} RangeTask;
+
+static void split_range(int start, int end, int grain, range_func func, void *arg);
+
+static void range_task(void *arg) {
+    RangeTask *r = arg;
+    split_range(r->start, r->end, r->grain, r->func, r->arg);
+}
+
+static void split_range(int start, int end, int grain, range_func func, void *arg) {
+    if (end - start <= grain) {
+        func(start, end, arg);
+        return;
+    }
+    int mid = start + (end - start) / 2;
+    RangeTask right = {mid, end, grain, func, arg};
+
+    TaskGroup g;
+    init_task_group(&g);
+    task_spawn(&g, range_task, &right);
+    split_range(start, mid, grain, func, arg);
+    task_sync(&g);
+}
+
+void parallel_for(int start, int end, int grain, range_func func, void *arg) {
+    if (end <= start)
+        return;
+    if (grain <= 0) {
+        // Aim for a few ranges per worker so that stealing can balance the load
+        grain = (end - start) / (4 * scheduler_num_workers());
+        grain = max(grain, 1);
+    }
+    if (end - start <= grain || scheduler_num_workers() == 1) {
+        func(start, end, arg);
+        return;
+    }
+    split_range(start, end, grain, func, arg);
+}
@@ -0,0 +1,98 @@
+#ifndef SCHEDULER_HEADER
+#define SCHEDULER_HEADER
+
+#include "libs.h"
+#include <stdatomic.h>
+
+#define MAX_WORKERS 64
+#define DEQUE_CAPACITY 1024
+
+typedef void (*task_func)(void *arg);
+typedef void (*range_func)(int start, int end, void *arg);
+
+// Set of spawned tasks that can be waited upon together
+typedef struct TaskGroup {
+    atomic_int pending;
+} TaskGroup;
+
+typedef struct Task {
+    task_func func;
+    void *arg;
+    TaskGroup *group;
+} Task;
+
+// ############################## SCHEDULER LIFECYCLE ##################################
+
+/**
+ * @brief start the work-stealing scheduler
+ *
+ * The scheduler is started lazily by the first spawn, so calling this function is
+ * only needed to pick the number of workers explicitly. The calling thread takes part
+ * in the computation whenever it waits on a task group, hence num_workers - 1 threads
+ * are created.
+ *
+ * @param num_workers number of workers (0 to use every online processor)
+ */
+void scheduler_init(int num_workers);
+
+/**
+ * @brief stop the scheduler and join its threads
+ *
+ * Must only be called when no task is in flight.
+ */
+void scheduler_shutdown(void);
+
+/**
+ * @brief get the number of workers of the scheduler (including the calling thread)
+ *
+ * @return int number of workers
+ */
+int scheduler_num_workers(void);
+
+// ################################ TASK PRIMITIVES ####################################
+
+/**
+ * @brief initialise an empty task group
+ *
+ * @param g task group
+ */
+void init_task_group(TaskGroup *g);
+
+/**
+ * @brief push a task onto the deque of the calling worker
+ *
+ * The task may be executed by any worker, which steals it from the top of the deque
+ * while its owner keeps popping from the bottom. arg must remain valid until the
+ * group has been synchronised.
+ *
+ * @param g group the task belongs to
+ * @param func function to execute
+ * @param arg argument passed to func
+ */
+void task_spawn(TaskGroup *g, task_func func, void *arg);
+
+/**
+ * @brief wait for every task of a group to complete
+ *
+ * Instead of blocking, the calling thread executes pending tasks (its own first, then
+ * stolen ones), so that nested parallel regions never deadlock nor oversubscribe.
+ *
+ * @param g task group
+ */
+void task_sync(TaskGroup *g);
+
+// ################################ PARALLEL LOOPS #####################################
+
+/**
+ * @brief run func over [start, end) by recursively splitting the range into tasks
+ *
+ * @param start first index
+ * @param end last index (excluded)
+ * @param grain size under which a range is no longer split (0 to pick one from the
+ *        number of workers)
+ * @param func function called on each subrange
+ * @param arg argument passed to func
+ */
+void parallel_for(int start, int end, int grain, range_func func, void *arg);
+
+#endif
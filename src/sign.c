@@ -0,0 +1,127 @@
+#include "sign.h"
+#include <string.h>
+
+// ############################## SIGN MATRIX CONSTRUCTION #############################
+
+typedef struct SignFill {
+    SignMatrix *s;
+    uint64_t seed;
+} SignFill;
+
+// Same streams and draws as the columns of rademacher_matrix
+static void sign_columns(int start, int end, void *arg) {
+    const SignFill *f = arg;
+    int rows = f->s->rows;
+    for (int j = start; j < end; j++) {
+        uint64_t state = random_stream(f->seed, j / GEMM_NC, (uint64_t) (j % GEMM_NC) * ((rows + 63) / 64)), bits = 0;
+        int8_t *col = f->s->items + (size_t) j * rows;
+        for (int i = 0; i < rows; i++) {
+            if (i % 64 == 0)
+                bits = splitmix64(&state);
+            col[i] = (bits >> (i % 64) & 1) ? 1 : -1;
+        }
+    }
+}
+
+SignMatrix *rademacher_sign_matrix(int rows, int cols) {
+    assert(rows > 0 && cols > 0);
+    SignMatrix *s = malloc(sizeof(SignMatrix));
+    s->rows = rows;
+    s->cols = cols;
+    s->name = "S";
+    s->items = malloc((size_t) rows * cols * sizeof *s->items);
+
+    SignFill f = {s, random_seed()};
+    parallel_for(0, cols, GEMM_NC, sign_columns, &f);
+    return s;
+}
+
+void free_sign_matrix(SignMatrix *s) {
+    assert(s != NULL);
+    free(s->items);
+}
+
+Matrix *matrix_from_sign_matrix(const SignMatrix *s) {
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "M", s->rows, s->cols);
+    for (int j = 0; j < s->cols; j++)
+        for (int i = 0; i < s->rows; i++)
+            m->items[j].items[i] = s->items[(size_t) j * s->rows + i];
+    return m;
+}
+
+// ############################### SIGN MATRIX PRODUCTS ################################
+
+// Sign matrix read as S or S^T by a product
+typedef struct SignOperand {
+    const SignMatrix *s;
+    bool trans;
+} SignOperand;
+
+// pack_func of a SignOperand: widen the block to r, which it always is
+static bool pack_signs(const void *x, int i0, int rows, int j0, int cols, float _Complex *p, float *r) {
+    (void) p;
+    const SignOperand *o = x;
+    const SignMatrix *s = o->s;
+    for (int j = 0; j < cols; j++) {
+        float *restrict dst = r + (size_t) j * rows;
+        if (!o->trans) {
+            const int8_t *restrict src = s->items + (size_t) (j0 + j) * s->rows + i0;
+            for (int i = 0; i < rows; i++)
+                dst[i] = src[i];
+        } else {
+            for (int i = 0; i < rows; i++)
+                dst[i] = s->items[(size_t) (i0 + i) * s->rows + j0 + j];
+        }
+    }
+    return true;
+}
+
+Matrix *sign_matrix_gemm(float _Complex alpha, const SignMatrix *s, bool trans, const Matrix *b, float _Complex beta, Matrix *c) {
+    SignOperand o = {s, trans};
+    GemmOperand ga = {trans ? s->cols : s->rows, trans ? s->rows : s->cols, pack_signs, &o};
+    MatrixView vb = view_of(b);
+    return matrix_gemm_packed(alpha, ga, view_operand(&vb), beta, c);
+}
+
+Vector *sign_matrix_gemv(float _Complex alpha, const SignMatrix *s, bool trans, const Vector *x, float _Complex beta, Vector *y) {
+    if (y == NULL) {
+        y = malloc(sizeof(Vector));
+        init_vector(y, "V", trans ? s->cols : s->rows);
+        beta = 0.0f;
+    }
+    // Single columns have the layout of matrices
+    Matrix xm = {x->capacity, 1, (Vector *) x, "X"};
+    Matrix ym = {y->capacity, 1, y, "Y"};
+    sign_matrix_gemm(alpha, s, trans, &xm, beta, &ym);
+    return y;
+}
+
+typedef struct SignMult {
+    const SignMatrix *a;
+    const SignMatrix *b;
+    int32_t *c;
+} SignMult;
+
+static void sign_mult_columns(int start, int end, void *arg) {
+    const SignMult *g = arg;
+    int m = g->a->rows, k = g->a->cols;
+    for (int j = start; j < end; j++) {
+        int32_t *restrict c = g->c + (size_t) j * m;
+        const int8_t *b = g->b->items + (size_t) j * k;
+        for (int p = 0; p < k; p++) {
+            const int8_t *restrict a = g->a->items + (size_t) p * m;
+            const int32_t bp = b[p];
+            for (int i = 0; i < m; i++)
+                c[i] += bp * a[i];
+        }
+    }
+}
+
+int32_t *sign_matrix_mult(const SignMatrix *a, const SignMatrix *b) {
+    assert(a->cols == b->rows);
+    int32_t *c = calloc((size_t) a->rows * b->cols, sizeof *c);
+    SignMult g = {a, b, c};
+    parallel_for(0, b->cols, max(1, GEMV_ROW_BLOCK / a->rows), sign_mult_columns, &g);
+    return c;
+}
@@ -0,0 +1,89 @@
+#ifndef SIGN_HEADER
+#define SIGN_HEADER
+
+#include "matrix.h"
+#include <stdint.h>
+
+// Matrix of +/-1 entries, such as a Rademacher sketching matrix, stored by columns with
+// one byte per entry: 8 times less memory than a Matrix. Element (i, j) is
+// items[j * rows + i].
+typedef struct SignMatrix {
+    int rows;
+    int cols;
+    int8_t *items;
+    char *name;
+} SignMatrix;
+
+// ############################## SIGN MATRIX CONSTRUCTION #############################
+
+/**
+ * @brief create a random matrix containing +/- 1 with equal probability
+ *
+ * Draws the same entries as rademacher_matrix for the same state of rand().
+ *
+ * @param rows # of rows
+ * @param cols # of columns
+ * @return SignMatrix* the resulting matrix
+ */
+SignMatrix *rademacher_sign_matrix(int rows, int cols);
+
+/**
+ * @brief remove a sign matrix from memory
+ *
+ * @param s matrix to be removed
+ */
+void free_sign_matrix(SignMatrix *s);
+
+/**
+ * @brief widen a sign matrix to a complex matrix
+ *
+ * @param s sign matrix
+ * @return Matrix* copy of s
+ */
+Matrix *matrix_from_sign_matrix(const SignMatrix *s);
+
+// ############################### SIGN MATRIX PRODUCTS ################################
+
+/**
+ * @brief compute C = alpha op(S) B + beta C, op(S) being S or S^T
+ *
+ * Blocks of S are widened to real floats straight into the packed buffers of
+ * matrix_gemm_packed and multiplied with real arithmetic, so that no more than a block
+ * of S is ever held as floats.
+ *
+ * @param alpha scalar multiplying the product
+ * @param s sign matrix
+ * @param trans whether to multiply by S^T instead of S
+ * @param b right operand
+ * @param beta scalar multiplying c (ignored if c is NULL)
+ * @param c matrix to update, or NULL to return a new matrix
+ * @return Matrix* the updated or new matrix C
+ */
+Matrix *sign_matrix_gemm(float _Complex alpha, const SignMatrix *s, bool trans, const Matrix *b, float _Complex beta, Matrix *c);
+
+/**
+ * @brief compute y = alpha op(S) x + beta y, op(S) being S or S^T
+ *
+ * @param alpha scalar multiplying the product
+ * @param s sign matrix
+ * @param trans whether to multiply by S^T instead of S
+ * @param x vector with as many rows as op(S) has columns
+ * @param beta scalar multiplying y (ignored if y is NULL)
+ * @param y vector to update, or NULL to return a new vector
+ * @return Vector* the updated or new vector y
+ */
+Vector *sign_matrix_gemv(float _Complex alpha, const SignMatrix *s, bool trans, const Vector *x, float _Complex beta, Vector *y);
+
+/**
+ * @brief return the exact product of two sign matrices
+ *
+ * Bytes are multiplied and accumulated in 32-bit integers, which cannot overflow
+ * below 2^31 inner products.
+ *
+ * @param a left operand
+ * @param b right operand
+ * @return int32_t* rows(a) x cols(b) product, stored by columns
+ */
+int32_t *sign_matrix_mult(const SignMatrix *a, const SignMatrix *b);
+
+#endif
@@ -0,0 +1,106 @@
+#include "sketch.h"
+#include "kernels.h"
+#include <string.h>
+
+// ############################ FREQUENT DIRECTIONS ####################################
+
+void init_frequent_directions(FrequentDirections *fd, int ell, int dim) {
+    assert(ell > 0 && dim > 0);
+    fd->ell = ell;
+    fd->dim = dim;
+    fd->filled = 0;
+    fd->shrinkage = 0.0f;
+    fd->buffer = malloc(sizeof(Matrix));
+    init_matrix(fd->buffer, "B", dim, 2 * ell);
+}
+
+void free_frequent_directions(FrequentDirections *fd) {
+    free_matrix(fd->buffer);
+    free(fd->buffer);
+}
+
+// Replace the buffered rows by sqrt(s_i^2 - s_ell^2) v_i^H, v_i being their right
+// singular vectors: at most ell rows are left
+static void shrink(FrequentDirections *fd) {
+    // The rows are the columns of the buffer, so their right singular vectors are the
+    // left singular vectors of the buffer
+    Matrix rows;
+    init_matrix_view(&rows, fd->buffer, 0, fd->dim, 0, fd->filled);
+    SVD *f = matrix_svd(&rows);
+    free_matrix_view(&rows);
+
+    int count = f->s->capacity;
+    float delta = 0.0f;
+    if (fd->ell < count)
+        delta = crealf(f->s->items[fd->ell]) * crealf(f->s->items[fd->ell]);
+    fd->shrinkage += delta;
+
+    int kept = 0;
+    for (int i = 0; i < min(fd->ell, count); i++) {
+        float s = crealf(f->s->items[i]);
+        if (s * s <= delta)
+            break;
+        memcpy(fd->buffer->items[i].items, f->u->items[i].items, fd->dim * sizeof *f->u->items[i].items);
+        complex_scal(fd->dim, sqrtf(s * s - delta), fd->buffer->items[i].items);
+        kept++;
+    }
+    for (int j = kept; j < fd->filled; j++)
+        memset(fd->buffer->items[j].items, 0, fd->dim * sizeof *fd->buffer->items[j].items);
+    fd->filled = kept;
+
+    free_svd(f);
+    free(f);
+}
+
+void frequent_directions_insert(FrequentDirections *fd, const Vector *row) {
+    assert(row->capacity == fd->dim);
+    if (fd->filled == 2 * fd->ell)
+        shrink(fd);
+    memcpy(fd->buffer->items[fd->filled++].items, row->items, fd->dim * sizeof *row->items);
+}
+
+void frequent_directions_insert_rows(FrequentDirections *fd, const Matrix *rows) {
+    assert(rows->cols == fd->dim);
+    for (int start = 0; start < rows->rows; ) {
+        if (fd->filled == 2 * fd->ell)
+            shrink(fd);
+        // Copy as many rows as fit in the buffer, reading the columns of rows contiguously
+        int count = min(2 * fd->ell - fd->filled, rows->rows - start);
+        for (int j = 0; j < fd->dim; j++) {
+            const float _Complex *column = rows->items[j].items + start;
+            for (int t = 0; t < count; t++)
+                fd->buffer->items[fd->filled + t].items[j] = column[t];
+        }
+        fd->filled += count;
+        start += count;
+    }
+}
+
+void frequent_directions_merge(FrequentDirections *fd, const FrequentDirections *other) {
+    assert(fd->ell == other->ell && fd->dim == other->dim);
+    for (int i = 0; i < other->filled; i++)
+        frequent_directions_insert(fd, other->buffer->items + i);
+    fd->shrinkage += other->shrinkage;
+}
+
+Matrix *frequent_directions_sketch(FrequentDirections *fd) {
+    if (fd->filled > fd->ell)
+        shrink(fd);
+    Matrix *b = malloc(sizeof(Matrix));
+    init_matrix(b, "B", fd->ell, fd->dim);
+    for (int j = 0; j < fd->dim; j++)
+        for (int i = 0; i < fd->filled; i++)
+            b->items[j].items[i] = fd->buffer->items[i].items[j];
+    return b;
+}
+
+// ################################ SIGN SKETCH ########################################
+
+Matrix *sign_sketch(const Matrix *a, int k) {
+    assert(k > 0);
+    SignMatrix *s = rademacher_sign_matrix(a->rows, k);
+    Matrix *b = sign_matrix_gemm(1.0f / sqrtf(k), s, true, a, 0.0f, NULL);
+    free_sign_matrix(s);
+    free(s);
+    return b;
+}
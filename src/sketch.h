@@ -0,0 +1,92 @@
+#ifndef SKETCH_HEADER
+#define SKETCH_HEADER
+
+#include "svd.h"
+#include "sign.h"
+
+// Frequent Directions sketch of a stream of rows of dimension dim: an ell x dim matrix
+// B such that ||A^H A - B^H B||_2 <= shrinkage <= ||A||_F^2 / ell, A being the matrix
+// of all the rows seen so far. Rows are buffered, the buffer of 2 ell rows being
+// shrunk back to at most ell rows by an SVD whenever it is full.
+typedef struct FrequentDirections {
+    int ell;
+    int dim;
+    int filled;         // number of buffered rows
+    Matrix *buffer;     // dim x (2 ell), the buffered rows being stored as columns
+    float shrinkage;    // sum of the squared singular values removed so far
+} FrequentDirections;
+
+// ############################ FREQUENT DIRECTIONS ####################################
+
+/**
+ * @brief initialise an empty Frequent Directions sketch
+ *
+ * @param fd sketch to initialise
+ * @param ell number of rows of the sketch
+ * @param dim dimension of the rows
+ */
+void init_frequent_directions(FrequentDirections *fd, int ell, int dim);
+
+/**
+ * @brief remove a Frequent Directions sketch from memory
+ *
+ * @param fd sketch
+ */
+void free_frequent_directions(FrequentDirections *fd);
+
+/**
+ * @brief add a row to a sketch
+ *
+ * Every ell rows the buffer is shrunk with an SVD of a dim x (2 ell) matrix, i.e.
+ * O(dim * ell) amortised time per row.
+ *
+ * @param fd sketch
+ * @param row vector of dimension dim
+ */
+void frequent_directions_insert(FrequentDirections *fd, const Vector *row);
+
+/**
+ * @brief add every row of a matrix to a sketch
+ *
+ * @param fd sketch
+ * @param rows matrix with dim columns
+ */
+void frequent_directions_insert_rows(FrequentDirections *fd, const Matrix *rows);
+
+/**
+ * @brief merge a sketch into another one
+ *
+ * The result sketches the rows of both streams with the same guarantee, so that
+ * sketches built by parallel workers on parts of a stream can be combined.
+ *
+ * @param fd sketch to update
+ * @param other sketch with the same ell and dim
+ */
+void frequent_directions_merge(FrequentDirections *fd, const FrequentDirections *other);
+
+/**
+ * @brief return the current sketch, shrinking the buffer if needed
+ *
+ * @param fd sketch
+ * @return Matrix* ell x dim matrix B
+ */
+Matrix *frequent_directions_sketch(FrequentDirections *fd);
+
+// ################################ SIGN SKETCH ########################################
+
+/**
+ * @brief compress the rows of a matrix with a random sign projection
+ *
+ * Returns S^T A / sqrt(k) for a Rademacher matrix S of k columns, stored as bytes, so
+ * that the norms of the vectors A x of any fixed set of N vectors are preserved up to
+ * a factor 1 +/- epsilon with high probability once k = O(log(N) / epsilon^2)
+ * (Johnson-Lindenstrauss). Unlike Frequent Directions, the sketch is oblivious: sketches
+ * of two matrices drawn from the same seed can be added.
+ *
+ * @param a matrix
+ * @param k number of rows of the sketch
+ * @return Matrix* k x cols(a) sketch
+ */
+Matrix *sign_sketch(const Matrix *a, int k);
+
+#endif
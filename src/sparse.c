@@ -0,0 +1,420 @@
+#include "sparse.h"
+#include "kernels.h"
+#ifdef __AVX2__
+    #include <immintrin.h>
+#endif
+
+// Rows (respectively columns) handled by a single task of the products
+#define ROW_GRAIN 256
+#define COL_GRAIN 4
+
+// ############################ SPARSE VECTOR CONSTRUCTION #############################
+
+static SparseVector *alloc_sparse_vector(int capacity, int nnz) {
+    SparseVector *u = malloc(sizeof(SparseVector));
+    u->capacity = capacity;
+    u->nnz = nnz;
+    u->indices = malloc(max(nnz, 1) * sizeof *u->indices);
+    u->values = malloc(max(nnz, 1) * sizeof *u->values);
+    return u;
+}
+
+typedef struct SparseEntry {
+    int index;
+    float _Complex value;
+} SparseEntry;
+
+static int compare_entries(const void *a, const void *b) {
+    int i = ((const SparseEntry *) a)->index, j = ((const SparseEntry *) b)->index;
+    return (i > j) - (i < j);
+}
+
+SparseVector *sparse_vector_from_arrays(int capacity, int nnz, const int *indices, const float _Complex *values) {
+    SparseEntry *entries = malloc(max(nnz, 1) * sizeof *entries);
+    for (int k = 0; k < nnz; k++) {
+        assert(indices[k] >= 0 && indices[k] < capacity);
+        entries[k] = (SparseEntry) {indices[k], values[k]};
+    }
+    qsort(entries, nnz, sizeof *entries, compare_entries);
+
+    SparseVector *u = alloc_sparse_vector(capacity, nnz);
+    int n = 0;
+    for (int k = 0; k < nnz; k++) {
+        if (n > 0 && u->indices[n - 1] == entries[k].index) {
+            u->values[n - 1] += entries[k].value;
+            continue;
+        }
+        u->indices[n] = entries[k].index;
+        u->values[n++] = entries[k].value;
+    }
+    u->nnz = n;
+    free(entries);
+    return u;
+}
+
+SparseVector *sparse_vector_from_dense(const Vector *v) {
+    int nnz = 0;
+    for (int i = 0; i < v->capacity; i++)
+        nnz += v->items[i] != 0.0f;
+    SparseVector *u = alloc_sparse_vector(v->capacity, nnz);
+    int k = 0;
+    for (int i = 0; i < v->capacity; i++)
+        if (v->items[i] != 0.0f) {
+            u->indices[k] = i;
+            u->values[k++] = v->items[i];
+        }
+    return u;
+}
+
+Vector *sparse_vector_to_dense(const SparseVector *u) {
+    Vector *v = malloc(sizeof(Vector));
+    init_vector(v, "V", u->capacity);
+    for (int k = 0; k < u->nnz; k++)
+        v->items[u->indices[k]] = u->values[k];
+    return v;
+}
+
+void free_sparse_vector(SparseVector *u) {
+    assert(u != NULL);
+    free(u->indices);
+    free(u->values);
+}
+
+// ############################ SPARSE VECTOR OPERATIONS ###############################
+
+__attribute__((hot))
+float _Complex sparse_dense_inner_product(const SparseVector *u, const Vector *v) {
+    assert(u->capacity == v->capacity);
+    const float *uf = (const float *) u->values;
+    const float *vf = (const float *) v->items;
+    float re = 0.0f, im = 0.0f;
+    int k = 0;
+
+    #ifdef __AVX2__
+    // A complex float is 8 bytes wide: gather four of them at once as doubles, then
+    // accumulate u*v and u*swap(v), whose lanes combine into u*conj(v)
+    __m256 re_sum = _mm256_setzero_ps();
+    __m256 im_sum = _mm256_setzero_ps();
+    for (; k + 4 <= u->nnz; k += 4) {
+        __m128i idx = _mm_loadu_si128((const __m128i *) (u->indices + k));
+        __m256 vv = _mm256_castpd_ps(_mm256_i32gather_pd((const double *) vf, idx, 8));
+        __m256 uu = _mm256_loadu_ps(uf + 2 * k);
+        re_sum = _mm256_add_ps(re_sum, _mm256_mul_ps(uu, vv));
+        im_sum = _mm256_add_ps(im_sum, _mm256_mul_ps(uu, _mm256_permute_ps(vv, 0xB1)));
+    }
+    float re_lanes[8], im_lanes[8];
+    _mm256_storeu_ps(re_lanes, re_sum);
+    _mm256_storeu_ps(im_lanes, im_sum);
+    for (int l = 0; l < 8; l += 2) {
+        re += re_lanes[l] + re_lanes[l + 1];
+        im += im_lanes[l + 1] - im_lanes[l];
+    }
+    #endif
+
+    for (; k < u->nnz; k++) {
+        int i = u->indices[k];
+        float a = uf[2*k], b = uf[2*k+1];
+        float c = vf[2*i], d = vf[2*i+1];
+        re += a * c + b * d;
+        im += b * c - a * d;
+    }
+    return CMPLXF(re, im);
+}
+
+// Find the first position at or after lo holding an index >= target, doubling the step
+// before a binary search
+static int gallop(const int *indices, int lo, int n, int target) {
+    int step = 1, hi = lo;
+    while (hi < n && indices[hi] < target) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = min(hi, n);
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (indices[mid] < target)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+float _Complex sparse_inner_product(const SparseVector *u, const SparseVector *v) {
+    assert(u->capacity == v->capacity);
+    float _Complex res = 0.0f;
+
+    if ((long) u->nnz * GALLOP_RATIO < v->nnz || (long) v->nnz * GALLOP_RATIO < u->nnz) {
+        bool u_small = u->nnz < v->nnz;
+        const SparseVector *small = u_small ? u : v, *large = u_small ? v : u;
+        int pos = 0;
+        for (int k = 0; k < small->nnz && pos < large->nnz; k++) {
+            pos = gallop(large->indices, pos, large->nnz, small->indices[k]);
+            if (pos < large->nnz && large->indices[pos] == small->indices[k]) {
+                float _Complex a = u_small ? small->values[k] : large->values[pos];
+                float _Complex b = u_small ? large->values[pos] : small->values[k];
+                res += complex_mult(a, conjf(b));
+            }
+        }
+        return res;
+    }
+
+    int i = 0, j = 0;
+    while (i < u->nnz && j < v->nnz) {
+        if (u->indices[i] < v->indices[j])
+            i++;
+        else if (u->indices[i] > v->indices[j])
+            j++;
+        else
+            res += complex_mult(u->values[i++], conjf(v->values[j++]));
+    }
+    return res;
+}
+
+void sparse_scatter_add(Vector *v, float _Complex a, const SparseVector *u) {
+    assert(u->capacity == v->capacity);
+    for (int k = 0; k < u->nnz; k++)
+        v->items[u->indices[k]] += complex_mult(a, u->values[k]);
+}
+
+float sparse_vector_L1_norm(const SparseVector *u) {
+    float res = 0.0f;
+    for (int k = 0; k < u->nnz; k++)
+        res += cabsf(u->values[k]);
+    return res;
+}
+
+float sparse_vector_L2_norm(const SparseVector *u) {
+    return sqrtf(crealf(complex_dotc(u->nnz, u->values, u->values)));
+}
+
+float sparse_vector_Lp_norm(const SparseVector *u, int p) {
+    assert(p > 0);
+    if (p == 1)
+        return sparse_vector_L1_norm(u);
+    if (p == 2)
+        return sparse_vector_L2_norm(u);
+    float res = 0.0f;
+    for (int k = 0; k < u->nnz; k++)
+        res += powf(cabsf(u->values[k]), (float) p);
+    return powf(res, 1.0f / (float) p);
+}
+
+// ############################ SPARSE MATRIX CONSTRUCTION #############################
+
+// Allocate a sparse matrix whose ptr array is zeroed
+static SparseMatrix *alloc_sparse_matrix(int rows, int cols, int nnz, SparseFormat format) {
+    SparseMatrix *s = malloc(sizeof(SparseMatrix));
+    s->rows = rows;
+    s->cols = cols;
+    s->nnz = nnz;
+    s->format = format;
+    s->ptr = calloc((format == SPARSE_CSR ? rows : cols) + 1, sizeof *s->ptr);
+    s->indices = malloc(max(nnz, 1) * sizeof *s->indices);
+    s->values = malloc(max(nnz, 1) * sizeof *s->values);
+    return s;
+}
+
+SparseMatrix *sparse_from_dense(const Matrix *m, SparseFormat format) {
+    int nnz = 0;
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            nnz += m->items[j].items[i] != 0.0f;
+
+    SparseMatrix *s = alloc_sparse_matrix(m->rows, m->cols, nnz, format);
+    if (format == SPARSE_CSC) {
+        int k = 0;
+        for (int j = 0; j < m->cols; j++) {
+            for (int i = 0; i < m->rows; i++)
+                if (m->items[j].items[i] != 0.0f) {
+                    s->indices[k] = i;
+                    s->values[k++] = m->items[j].items[i];
+                }
+            s->ptr[j + 1] = k;
+        }
+        return s;
+    }
+
+    // Count the nonzeros of every row, then fill the rows column by column
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            s->ptr[i + 1] += m->items[j].items[i] != 0.0f;
+    for (int i = 0; i < m->rows; i++)
+        s->ptr[i + 1] += s->ptr[i];
+    int *next = malloc(m->rows * sizeof *next);
+    memcpy(next, s->ptr, m->rows * sizeof *next);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            if (m->items[j].items[i] != 0.0f) {
+                s->indices[next[i]] = j;
+                s->values[next[i]++] = m->items[j].items[i];
+            }
+    free(next);
+    return s;
+}
+
+Matrix *sparse_to_dense(const SparseMatrix *s) {
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "M", s->rows, s->cols);
+    int outer = s->format == SPARSE_CSR ? s->rows : s->cols;
+    for (int k = 0; k < outer; k++)
+        for (int p = s->ptr[k]; p < s->ptr[k + 1]; p++) {
+            if (s->format == SPARSE_CSR)
+                m->items[s->indices[p]].items[k] = s->values[p];
+            else
+                m->items[k].items[s->indices[p]] = s->values[p];
+        }
+    return m;
+}
+
+// Swap the roles of the outer and inner dimensions with a counting sort on the
+// inner indices: the result has the same nonzeros as s, compressed the other way
+static SparseMatrix *recompress(const SparseMatrix *s, int rows, int cols, SparseFormat format) {
+    SparseMatrix *t = alloc_sparse_matrix(rows, cols, s->nnz, format);
+    int outer = s->format == SPARSE_CSR ? s->rows : s->cols;
+    int inner = s->format == SPARSE_CSR ? s->cols : s->rows;
+
+    for (int p = 0; p < s->nnz; p++)
+        t->ptr[s->indices[p] + 1]++;
+    for (int i = 0; i < inner; i++)
+        t->ptr[i + 1] += t->ptr[i];
+    int *next = malloc(max(inner, 1) * sizeof *next);
+    memcpy(next, t->ptr, inner * sizeof *next);
+    // Visiting the outer dimension in order keeps the new indices sorted
+    for (int k = 0; k < outer; k++)
+        for (int p = s->ptr[k]; p < s->ptr[k + 1]; p++) {
+            int q = next[s->indices[p]]++;
+            t->indices[q] = k;
+            t->values[q] = s->values[p];
+        }
+    free(next);
+    return t;
+}
+
+SparseMatrix *sparse_convert(const SparseMatrix *s, SparseFormat format) {
+    if (format != s->format)
+        return recompress(s, s->rows, s->cols, format);
+    SparseMatrix *t = alloc_sparse_matrix(s->rows, s->cols, s->nnz, format);
+    memcpy(t->ptr, s->ptr, ((format == SPARSE_CSR ? s->rows : s->cols) + 1) * sizeof *t->ptr);
+    memcpy(t->indices, s->indices, s->nnz * sizeof *t->indices);
+    memcpy(t->values, s->values, s->nnz * sizeof *t->values);
+    return t;
+}
+
+void free_sparse_matrix(SparseMatrix *s) {
+    assert(s != NULL);
+    free(s->ptr);
+    free(s->indices);
+    free(s->values);
+}
+
+// ############################ SPARSE MATRIX OPERATIONS ###############################
+
+SparseMatrix *sparse_transpose(const SparseMatrix *s) {
+    return recompress(s, s->cols, s->rows, s->format);
+}
+
+// y = s x for a single dense column, reading x by gathers (CSR)
+static void csr_mult_column(const SparseMatrix *s, int start, int end, const float _Complex *x, float _Complex *y) {
+    for (int i = start; i < end; i++) {
+        float re = 0.0f, im = 0.0f;
+        for (int p = s->ptr[i]; p < s->ptr[i + 1]; p++) {
+            float _Complex z = complex_mult(s->values[p], x[s->indices[p]]);
+            re += crealf(z);
+            im += cimagf(z);
+        }
+        y[i] = CMPLXF(re, im);
+    }
+}
+
+// y += s[:, start:end] x[start:end], writing y by scatters (CSC)
+static void csc_mult_column(const SparseMatrix *s, int start, int end, const float _Complex *x, float _Complex *y) {
+    for (int j = start; j < end; j++) {
+        if (x[j] == 0.0f)
+            continue;
+        for (int p = s->ptr[j]; p < s->ptr[j + 1]; p++)
+            y[s->indices[p]] += complex_mult(s->values[p], x[j]);
+    }
+}
+
+typedef struct SparseProduct {
+    const SparseMatrix *s;
+    const float _Complex *x;
+    float _Complex *y;
+    float _Complex **partials;  // per-task accumulators of the CSC product
+    int ntasks;
+} SparseProduct;
+
+static void csr_mult_rows(int start, int end, void *arg) {
+    const SparseProduct *t = arg;
+    csr_mult_column(t->s, start, end, t->x, t->y);
+}
+
+static void csc_mult_chunks(int start, int end, void *arg) {
+    const SparseProduct *t = arg;
+    int cols = t->s->cols;
+    for (int c = start; c < end; c++) {
+        t->partials[c] = calloc(t->s->rows, sizeof **t->partials);
+        csc_mult_column(t->s, (long) cols * c / t->ntasks, (long) cols * (c + 1) / t->ntasks, t->x, t->partials[c]);
+    }
+}
+
+static void csc_reduce_rows(int start, int end, void *arg) {
+    const SparseProduct *t = arg;
+    for (int c = 0; c < t->ntasks; c++)
+        for (int i = start; i < end; i++)
+            t->y[i] += t->partials[c][i];
+}
+
+Vector *sparse_mult_vector(const SparseMatrix *s, const Vector *v) {
+    assert(v->capacity == s->cols);
+    Vector *r = malloc(sizeof(Vector));
+    init_vector(r, "V", s->rows);
+
+    SparseProduct t = {s, v->items, r->items, NULL, 1};
+    if (s->format == SPARSE_CSR) {
+        parallel_for(0, s->rows, ROW_GRAIN, csr_mult_rows, &t);
+        return r;
+    }
+
+    // Splitting the columns by nonzeros would balance better, but the work-stealing
+    // scheduler already absorbs moderate imbalance
+    t.ntasks = min(scheduler_num_workers(), max(s->cols / ROW_GRAIN, 1));
+    if (t.ntasks == 1) {
+        csc_mult_column(s, 0, s->cols, v->items, r->items);
+        return r;
+    }
+    t.partials = malloc(t.ntasks * sizeof *t.partials);
+    parallel_for(0, t.ntasks, 1, csc_mult_chunks, &t);
+    parallel_for(0, s->rows, ROW_GRAIN, csc_reduce_rows, &t);
+    for (int c = 0; c < t.ntasks; c++)
+        free(t.partials[c]);
+    free(t.partials);
+    return r;
+}
+
+typedef struct SparseMatrixProduct {
+    const SparseMatrix *s;
+    const Matrix *m;
+    Matrix *r;
+} SparseMatrixProduct;
+
+static void sparse_mult_columns(int start, int end, void *arg) {
+    const SparseMatrixProduct *t = arg;
+    for (int j = start; j < end; j++) {
+        if (t->s->format == SPARSE_CSR)
+            csr_mult_column(t->s, 0, t->s->rows, t->m->items[j].items, t->r->items[j].items);
+        else
+            csc_mult_column(t->s, 0, t->s->cols, t->m->items[j].items, t->r->items[j].items);
+    }
+}
+
+Matrix *sparse_mult_matrix(const SparseMatrix *s, const Matrix *m) {
+    assert(m->rows == s->cols);
+    Matrix *r = malloc(sizeof(Matrix));
+    init_matrix(r, "M", s->rows, m->cols);
+    SparseMatrixProduct t = {s, m, r};
+    parallel_for(0, m->cols, COL_GRAIN, sparse_mult_columns, &t);
+    return r;
+}
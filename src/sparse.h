@@ -0,0 +1,203 @@
+#ifndef SPARSE_HEADER
+#define SPARSE_HEADER
+
+#include "matrix.h"
+
+// Storage orders of a compressed sparse matrix
+typedef enum SparseFormat {
+    SPARSE_CSR,     // compressed sparse rows
+    SPARSE_CSC      // compressed sparse columns
+} SparseFormat;
+
+// Compressed sparse matrix. The nonzeros of row (CSR) or column (CSC) k are stored at
+// positions ptr[k] to ptr[k+1]-1 of indices and values, sorted by index.
+typedef struct SparseMatrix {
+    int rows;
+    int cols;
+    int nnz;
+    SparseFormat format;
+    int *ptr;                   // rows+1 (CSR) or cols+1 (CSC) offsets
+    int *indices;               // column (CSR) or row (CSC) of each nonzero
+    float _Complex *values;
+} SparseMatrix;
+
+// Sparse vector: the nnz nonzero coordinates, sorted by index, of a vector of dimension
+// capacity
+typedef struct SparseVector {
+    int capacity;
+    int nnz;
+    int *indices;
+    float _Complex *values;
+} SparseVector;
+
+// Size ratio above which sparse-sparse kernels gallop through the larger vector
+// instead of merging both
+#define GALLOP_RATIO 16
+
+// ############################ SPARSE VECTOR CONSTRUCTION #############################
+
+/**
+ * @brief build a sparse vector from (index, value) pairs given in any order
+ * 
+ * Pairs are sorted by index and the values of repeated indices are summed.
+ * 
+ * @param capacity dimension of the vector
+ * @param nnz number of pairs
+ * @param indices coordinates, between 0 and capacity-1
+ * @param values values of the coordinates
+ * @return SparseVector* the sparse vector
+ */
+SparseVector *sparse_vector_from_arrays(int capacity, int nnz, const int *indices, const float _Complex *values);
+
+/**
+ * @brief compress the nonzero elements of a dense vector
+ * 
+ * @param v dense vector
+ * @return SparseVector* the sparse vector
+ */
+SparseVector *sparse_vector_from_dense(const Vector *v);
+
+/**
+ * @brief expand a sparse vector into a dense one
+ * 
+ * @param u sparse vector
+ * @return Vector* the dense vector
+ */
+Vector *sparse_vector_to_dense(const SparseVector *u);
+
+/**
+ * @brief remove a sparse vector from memory
+ * 
+ * @param u sparse vector
+ */
+void free_sparse_vector(SparseVector *u);
+
+// ############################ SPARSE VECTOR OPERATIONS ###############################
+
+/**
+ * @brief compute the inner product of a sparse and a dense vector (conjugating the
+ * dense one, like vector_inner_product), in O(nnz) time
+ * 
+ * The dense elements are gathered with AVX2 instructions when they are available.
+ * 
+ * @param u sparse vector
+ * @param v dense vector of the same dimension
+ * @return float _Complex the inner product
+ */
+float _Complex sparse_dense_inner_product(const SparseVector *u, const Vector *v);
+
+/**
+ * @brief compute the inner product of two sparse vectors (conjugating the second one)
+ * 
+ * Indices are merged in O(nnz(u) + nnz(v)) time, or the smaller vector is looked up
+ * in the larger one by galloping search when their sizes differ by more than
+ * GALLOP_RATIO, in O(min log(max / min)) time.
+ * 
+ * @param u first sparse vector
+ * @param v second sparse vector of the same dimension
+ * @return float _Complex the inner product
+ */
+float _Complex sparse_inner_product(const SparseVector *u, const SparseVector *v);
+
+/**
+ * @brief compute v += a u, touching only the nonzeros of u
+ * 
+ * @param v dense vector to update
+ * @param a scalar
+ * @param u sparse vector of the same dimension
+ */
+void sparse_scatter_add(Vector *v, float _Complex a, const SparseVector *u);
+
+/**
+ * @brief compute the L1 norm of a sparse vector
+ * 
+ * @param u sparse vector
+ * @return float resulting norm
+ */
+float sparse_vector_L1_norm(const SparseVector *u);
+
+/**
+ * @brief compute the L2 norm of a sparse vector
+ * 
+ * @param u sparse vector
+ * @return float resulting norm
+ */
+float sparse_vector_L2_norm(const SparseVector *u);
+
+/**
+ * @brief compute the Lp norm of a sparse vector
+ * 
+ * @param u sparse vector
+ * @param p norm to compute
+ * @return float resulting norm
+ */
+float sparse_vector_Lp_norm(const SparseVector *u, int p);
+
+// ############################ SPARSE MATRIX CONSTRUCTION #############################
+
+/**
+ * @brief compress the nonzero elements of a dense matrix
+ * 
+ * @param m dense matrix
+ * @param format storage order of the result
+ * @return SparseMatrix* the compressed matrix
+ */
+SparseMatrix *sparse_from_dense(const Matrix *m, SparseFormat format);
+
+/**
+ * @brief expand a sparse matrix into a dense one
+ * 
+ * @param s sparse matrix
+ * @return Matrix* the dense matrix
+ */
+Matrix *sparse_to_dense(const SparseMatrix *s);
+
+/**
+ * @brief change the storage order of a sparse matrix, in O(nnz + rows + cols) time
+ * 
+ * @param s sparse matrix
+ * @param format storage order of the result
+ * @return SparseMatrix* a copy of s in the requested format
+ */
+SparseMatrix *sparse_convert(const SparseMatrix *s, SparseFormat format);
+
+/**
+ * @brief remove a sparse matrix from memory
+ * 
+ * @param s sparse matrix
+ */
+void free_sparse_matrix(SparseMatrix *s);
+
+// ############################ SPARSE MATRIX OPERATIONS ###############################
+
+/**
+ * @brief transpose a sparse matrix, keeping its storage order
+ * 
+ * @param s sparse matrix
+ * @return SparseMatrix* the transposed matrix
+ */
+SparseMatrix *sparse_transpose(const SparseMatrix *s);
+
+/**
+ * @brief multiply a sparse matrix by a dense vector
+ * 
+ * CSR rows are processed in parallel; CSC columns are split between the workers,
+ * each scattering into its own accumulator before the accumulators are summed.
+ * 
+ * @param s sparse matrix
+ * @param v dense vector with as many rows as s has columns
+ * @return Vector* the product s v
+ */
+Vector *sparse_mult_vector(const SparseMatrix *s, const Vector *v);
+
+/**
+ * @brief multiply a sparse matrix by a dense matrix, the columns of the result being
+ * computed in parallel
+ * 
+ * @param s sparse matrix
+ * @param m dense matrix with as many rows as s has columns
+ * @return Matrix* the product s m
+ */
+Matrix *sparse_mult_matrix(const SparseMatrix *s, const Matrix *m);
+
+#endif
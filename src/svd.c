@@ -0,0 +1,206 @@
+#include "svd.h"
+#include "kernels.h"
+#include <float.h>
+
+// ############################### ONE-SIDED JACOBI ####################################
+
+// One round of the Jacobi sweep: the pairs (order[i], order[npairs*2-1-i]) are disjoint
+typedef struct JacobiRound {
+    Matrix *u;
+    Matrix *v;
+    const int *order;
+    int npairs;
+    float tol;
+    atomic_int rotations;
+} JacobiRound;
+
+// Compute (p, q) <- (c p - s q, s p + c q)
+static void rotate_pair(int n, float c, float s, float _Complex *restrict p, float _Complex *restrict q) {
+    float *pf = (float *) p;
+    float *qf = (float *) q;
+    for (int i = 0; i < 2 * n; i++) {
+        float x = pf[i], y = qf[i];
+        pf[i] = c * x - s * y;
+        qf[i] = s * x + c * y;
+    }
+}
+
+static void jacobi_rotate_pairs(int start, int end, void *arg) {
+    JacobiRound *r = arg;
+    int m = r->u->rows, n = r->v->rows;
+    for (int i = start; i < end; i++) {
+        int p = r->order[i], q = r->order[2 * r->npairs - 1 - i];
+        if (p < 0 || q < 0)
+            continue;
+        float _Complex *up = r->u->items[p].items, *uq = r->u->items[q].items;
+        float alpha = crealf(complex_dotc(m, up, up));
+        float beta = crealf(complex_dotc(m, uq, uq));
+        float _Complex gamma = complex_dotc(m, up, uq);
+        float g = cabsf(gamma);
+        if (g <= r->tol * sqrtf(alpha * beta))
+            continue;
+
+        // Turn the inner product real by rotating the phase of column q
+        float _Complex phase = conjf(gamma) / g;
+        complex_scal(m, phase, uq);
+        complex_scal(n, phase, r->v->items[q].items);
+
+        float zeta = (beta - alpha) / (2.0f * g);
+        float t = copysignf(1.0f, zeta) / (fabsf(zeta) + sqrtf(1.0f + zeta * zeta));
+        float c = 1.0f / sqrtf(1.0f + t * t);
+        rotate_pair(m, c, c * t, up, uq);
+        rotate_pair(n, c, c * t, r->v->items[p].items, r->v->items[q].items);
+        atomic_fetch_add_explicit(&r->rotations, 1, memory_order_relaxed);
+    }
+}
+
+// Orthogonalise the columns of u (m >= n), accumulating the rotations in v
+static void jacobi_orthogonalize(Matrix *u, Matrix *v) {
+    int n = u->cols;
+    int npairs = (n + 1) / 2;
+    // Round-robin tournament: order[0] is fixed and the others rotate every round,
+    // a padding -1 sitting out when n is odd
+    int *order = malloc(2 * npairs * sizeof *order);
+    for (int i = 0; i < 2 * npairs; i++)
+        order[i] = i < n ? i : -1;
+
+    JacobiRound r = {u, v, order, npairs, sqrtf(u->rows) * FLT_EPSILON, 0};
+    for (int sweep = 0; sweep < MAX_SVD_SWEEPS; sweep++) {
+        atomic_store(&r.rotations, 0);
+        for (int round = 0; round < 2 * npairs - 1; round++) {
+            parallel_for(0, npairs, 1, jacobi_rotate_pairs, &r);
+            int last = order[2 * npairs - 1];
+            memmove(order + 2, order + 1, (2 * npairs - 2) * sizeof *order);
+            order[1] = last;
+        }
+        if (atomic_load(&r.rotations) == 0)
+            break;
+    }
+    free(order);
+}
+
+// Compute the SVD of a matrix with at least as many rows as columns
+static SVD *tall_svd(const Matrix *m) {
+    int n = m->cols;
+    SVD *f = malloc(sizeof(SVD));
+    f->u = matrix_copy(m);
+    f->v = identity_matrix(n);
+    jacobi_orthogonalize(f->u, f->v);
+
+    // The singular values are the norms of the orthogonal columns: sort them by
+    // swapping column headers, then normalise
+    float *norms = malloc(n * sizeof *norms);
+    for (int j = 0; j < n; j++)
+        norms[j] = sqrtf(crealf(complex_dotc(m->rows, f->u->items[j].items, f->u->items[j].items)));
+    for (int i = 0; i < n - 1; i++) {
+        int best = i;
+        for (int j = i + 1; j < n; j++)
+            if (norms[j] > norms[best])
+                best = j;
+        float tmp_norm = norms[i];
+        norms[i] = norms[best];
+        norms[best] = tmp_norm;
+        Vector tmp = f->u->items[i];
+        f->u->items[i] = f->u->items[best];
+        f->u->items[best] = tmp;
+        tmp = f->v->items[i];
+        f->v->items[i] = f->v->items[best];
+        f->v->items[best] = tmp;
+    }
+
+    f->s = malloc(sizeof(Vector));
+    init_vector(f->s, "S", n);
+    for (int j = 0; j < n; j++) {
+        update_vector(f->s, norms[j], j);
+        if (norms[j] > 0.0f)
+            complex_scal(m->rows, 1.0f / norms[j], f->u->items[j].items);
+    }
+    free(norms);
+    return f;
+}
+
+SVD *matrix_svd(const Matrix *m) {
+    if (m->rows >= m->cols)
+        return tall_svd(m);
+    // A^H = V S U^H
+    Matrix *mh = matrix_conj_transpose(m);
+    SVD *f = tall_svd(mh);
+    Matrix *tmp = f->u;
+    f->u = f->v;
+    f->v = tmp;
+    free_matrix(mh);
+    free(mh);
+    return f;
+}
+
+void free_svd(SVD *f) {
+    assert(f != NULL);
+    free_matrix(f->u);
+    free_vector(f->s);
+    free_matrix(f->v);
+    free(f->u);
+    free(f->s);
+    free(f->v);
+}
+
+// ############################## RANDOMIZED SVD #######################################
+
+// Replace y with an orthonormal basis of its range
+static Matrix *orthonormalize(Matrix *y) {
+    QR *f = qr_factorize_inplace(y);
+    Matrix *q = qr_q(f);
+    free_qr(f);
+    free(f);
+    free_matrix(y);
+    free(y);
+    return q;
+}
+
+// Drop all but the first k columns of m
+static void keep_leading_columns(Matrix *m, int k) {
+    for (int j = k; j < m->cols; j++)
+        free_vector(m->items + j);
+    m->cols = k;
+}
+
+SVD *randomized_svd(const Matrix *m, int k, int oversampling, int power_iterations) {
+    int l = min(k + oversampling, min(m->rows, m->cols));
+    assert(k > 0 && k <= l);
+
+    Matrix *omega = gaussian_matrix(m->cols, l);
+    Matrix *q = orthonormalize(matrix_mult(m, omega));
+    free_matrix(omega);
+    free(omega);
+    for (int it = 0; it < power_iterations; it++) {
+        Matrix *z = orthonormalize(matrix_gemm(1.0f, view_conj_transpose(m), view_of(q), 0.0f, NULL));
+        free_matrix(q);
+        free(q);
+        q = orthonormalize(matrix_mult(m, z));
+        free_matrix(z);
+        free(z);
+    }
+
+    // B = Q^H A is small: B^H = U_b S V_b^H gives A ~ (Q V_b) S U_b^H
+    Matrix *bh = matrix_gemm(1.0f, view_conj_transpose(m), view_of(q), 0.0f, NULL);
+    SVD *core = matrix_svd(bh);
+    keep_leading_columns(core->u, k);
+    keep_leading_columns(core->v, k);
+
+    SVD *f = malloc(sizeof(SVD));
+    f->u = matrix_mult(q, core->v);
+    f->s = malloc(sizeof(Vector));
+    init_vector(f->s, "S", k);
+    memcpy(f->s->items, core->s->items, k * sizeof *f->s->items);
+    f->v = core->u;
+
+    free_matrix(bh);
+    free_matrix(q);
+    free_matrix(core->v);
+    free_vector(core->s);
+    free(bh);
+    free(q);
+    free(core->v);
+    free(core->s);
+    free(core);
+    return f;
+}
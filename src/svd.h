@@ -0,0 +1,54 @@
+#ifndef SVD_HEADER
+#define SVD_HEADER
+
+#include "decompositions.h"
+
+// Maximum number of sweeps of the one-sided Jacobi algorithm
+#define MAX_SVD_SWEEPS 30
+
+// Thin singular value decomposition A = U diag(s) V^H
+typedef struct SVD {
+    Matrix *u;      // left singular vectors in columns
+    Vector *s;      // real singular values in descending order
+    Matrix *v;      // right singular vectors in columns
+} SVD;
+
+// ########################### SINGULAR VALUE DECOMPOSITION ############################
+
+/**
+ * @brief compute the thin singular value decomposition of a matrix
+ *
+ * One-sided Jacobi algorithm: pairs of columns are orthogonalised by plane rotations
+ * until they are all orthogonal, the independent pairs of each round being rotated in
+ * parallel. Accurate even for small singular values, and fast for matrices with few
+ * columns such as the core of randomized_svd.
+ *
+ * @param m matrix of any shape
+ * @return SVD* decomposition with min(rows, cols) singular triplets
+ */
+SVD *matrix_svd(const Matrix *m);
+
+/**
+ * @brief compute an approximation of the k leading singular triplets of a matrix
+ *
+ * Randomized range finder of Halko, Martinsson and Tropp: the range of A is sampled
+ * with a gaussian test matrix of k + oversampling columns, sharpened by power
+ * iterations (re-orthonormalised with QR), and the SVD of the projection of A on that
+ * range is computed exactly. Runs in O(mnk) time with O((m+n)k) extra memory.
+ *
+ * @param m matrix of any shape
+ * @param k number of singular triplets
+ * @param oversampling extra samples improving the approximation (5 to 10 is typical)
+ * @param power_iterations passes over A^H A, useful when the spectrum decays slowly
+ * @return SVD* rank-k decomposition
+ */
+SVD *randomized_svd(const Matrix *m, int k, int oversampling, int power_iterations);
+
+/**
+ * @brief remove a singular value decomposition from memory
+ *
+ * @param f decomposition
+ */
+void free_svd(SVD *f);
+
+#endif
@@ -1,9 +1,10 @@
 #include "vector.h"
+#include "numa.h"
 
 // ############################ VECTOR TYPE CONSTRUCTION ###############################
 
 __attribute__((cold))
-int init_vector(Vector *v, const char *name, int rows) {
+int init_vector_unfilled(Vector *v, const char *name, int rows) {
     if (rows <= 0) {
         fprintf(stderr, "init_vector: bad size %d\n", rows);
         errno = EINVAL;
@@ -21,26 +22,51 @@ int init_vector(Vector *v, const char *name, int rows) {
     
     float _Complex *items;
 
-    int ret = posix_memalign((void **)&items, SIMD_ALIGNMENT, rows * sizeof *items);
+    // Pages bound to a policy are mapped for the vector alone
+    v->mapped = alloc_policy_binds_pages();
+    int ret;
+    if (v->mapped) {
+        items = map_buffer((size_t) rows * sizeof *items);
+        ret = items == NULL;
+    } else {
+        ret = posix_memalign((void **)&items, SIMD_ALIGNMENT, rows * sizeof *items);
+    }
     if (ret != 0) {
         items = NULL;
-        perror("posix_memalign failed");
+        perror(v->mapped ? "map_buffer failed" : "posix_memalign failed");
         free(v->name);
         errno = ENOMEM;
         return VECTOR_ERR_OOM;
     }
 
     v->items = __builtin_assume_aligned(items, SIMD_ALIGNMENT);
-    memset(v->items, 0, (size_t) rows * sizeof *v->items);
     return VECTOR_SUCCESS;
 }
 
+__attribute__((cold))
+int init_vector(Vector *v, const char *name, int rows) {
+    int ret = init_vector_unfilled(v, name, rows);
+    if (ret == VECTOR_SUCCESS)
+        zero_fill(v->items, rows, sizeof *v->items);
+    return ret;
+}
+
 void free_vector(Vector *v) {
-    if (v->items != NULL)
+    if (v->items != NULL && v->mapped)
+        unmap_buffer(v->items, (size_t) v->capacity * sizeof *v->items);
+    else if (v->items != NULL)
         free(v->items);
     return;
 }
 
+void init_vector_view(Vector *view, const Vector *v, int start, int end) {
+    assert(0 <= start && start < end && end <= v->capacity);
+    view->capacity = end - start;
+    view->items = v->items + start;
+    view->name = v->name;
+    view->mapped = false;
+}
+
 // ############################## VECTOR SAFETY CHECKS #################################
 
 int check_strictly_positive_sizes(const Vector *u, const Vector *v) {
@@ -213,14 +239,35 @@ float vector_angle_between(const Vector *u, const Vector *v, bool radians) {
 
 // ############################### VECTOR GENERATION ###################################
 
+// Vector filled by blocks of FIRST_TOUCH_ROW_BLOCK elements, each from its own random
+// stream
+typedef struct RandomFill {
+    Vector *v;
+    uint64_t seed;
+} RandomFill;
+
+static void rademacher_rows(int start, int end, void *arg) {
+    const RandomFill *r = arg;
+    uint64_t state = 0, bits = 0;
+    for (int i = start; i < end; i++) {
+        // One bit per element
+        int offset = i % FIRST_TOUCH_ROW_BLOCK;
+        if (i == start || offset % 64 == 0) {
+            state = random_stream(r->seed, i / FIRST_TOUCH_ROW_BLOCK, offset / 64);
+            bits = splitmix64(&state);
+        }
+        r->v->items[i] = (bits >> (offset % 64) & 1) ? 1.0f : -1.0f;
+    }
+}
+
 Vector *rademacher_vector(int rows) {
     assert(rows > 0);
 
     Vector *v = malloc(sizeof(Vector));
     init_vector(v, "V", rows);
 
-    for (int i = 0; i < rows; i++)
-        update_vector(v, (rand() % 2 == 0) ? 1.0f + 0.0f * I : -1.0f + 0.0f * I, i);
+    RandomFill r = {v, random_seed()};
+    parallel_for(0, rows, FIRST_TOUCH_ROW_BLOCK, rademacher_rows, &r);
     return v;
 }
 
@@ -27,12 +27,13 @@ typedef struct Vector {
     int capacity;
     float _Complex *items;
     char *name;
+    bool mapped;    // items were mapped by map_buffer (see numa.h) rather than allocated
 } Vector;
 
 
 // ############################ VECTOR TYPE CONSTRUCTION ###############################
 /**
- * @brief initialise a vector
+ * @brief initialise a vector of zeroes, placed according to the allocation policy
  * 
  * @param v vector to initialise
  * @param name vector id
@@ -41,6 +42,20 @@ typedef struct Vector {
  */
 int init_vector(Vector *v, const char *name, int rows);
 
+/**
+ * @brief initialise a vector without writing its elements
+ * 
+ * The pages of the elements are bound to the allocation policy (see numa.h) but left
+ * untouched, so that the first thread writing them places them. Every element must be
+ * written before being read.
+ * 
+ * @param v vector to initialise
+ * @param name vector id
+ * @param rows number of rows the vector will have
+ * @return int status of the initialization (0 for success, negative int for failure)
+ */
+int init_vector_unfilled(Vector *v, const char *name, int rows);
+
 /**
  * @brief remove a vector from memory
  * 
@@ -48,6 +63,19 @@ int init_vector(Vector *v, const char *name, int rows);
  */
 void free_vector(Vector *v);
 
+/**
+ * @brief make a vector share the elements start to end-1 of another one, without copying
+ * 
+ * The view holds no memory of its own and must not be passed to free_vector; it is
+ * valid as long as v is.
+ * 
+ * @param view vector to initialise
+ * @param v vector to look into
+ * @param start first element of the view
+ * @param end element following the last one of the view
+ */
+void init_vector_view(Vector *view, const Vector *v, int start, int end);
+
 /**
  * @brief update a vector element
  * 
@@ -157,6 +185,9 @@ float vector_angle_between(const Vector *u, const Vector *v, bool radians);
  * @brief construct a vector with Rademacher random variables, i.e. r.v. that are
  * either -1 or 1 with equal probability
  * 
+ * Blocks of FIRST_TOUCH_ROW_BLOCK elements are filled in parallel from their own
+ * random streams, whose base seed is drawn from rand().
+ * 
  * @param rows 
  * @return Vector* pointer to the vector
  */
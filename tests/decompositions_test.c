@@ -0,0 +1,206 @@
+#include <check.h>
+#include "../src/decompositions.h"
+
+/**
+ * @brief Create a random diagonally dominant matrix
+ * 
+ * @param n # of rows and columns
+ * @return Matrix* well-conditioned matrix with +/- 1 off the diagonal
+ */
+Matrix *create_diagonally_dominant_matrix(int n) {
+    Matrix *m = rademacher_matrix(n, n);
+    for (int i = 0; i < n; i++)
+        update_matrix(m, 2.0f * n + 1.0f * I, i, i);
+    return m;
+}
+
+/**
+ * @brief Get the largest absolute difference between two matrices
+ * 
+ * @param m1 first matrix
+ * @param m2 second matrix
+ * @return float max |m1 - m2|
+ */
+float max_abs_difference(const Matrix *m1, const Matrix *m2) {
+    float diff = 0.0f;
+    for (int j = 0; j < m1->cols; j++)
+        for (int i = 0; i < m1->rows; i++)
+            diff = max(diff, cabsf(m1->items[j].items[i] - m2->items[j].items[i]));
+    return diff;
+}
+
+START_TEST(test_lu_determinant_of_permuted_matrix)
+{
+    // Rows of the upper triangular matrix diag(2, 3, 4) cyclically shifted
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "M", 3, 3);
+    update_matrix(m, 2, 1, 0); update_matrix(m, 1, 1, 1);
+    update_matrix(m, 3, 2, 1); update_matrix(m, 4, 0, 2);
+    LU *f = lu_factorize(m);
+    ck_assert(!f->singular);
+    ck_assert_float_eq_tol(crealf(lu_determinant(f)), 24.0f, 1e-5f);
+    ck_assert_float_eq_tol(crealf(lu_log_determinant(f)), logf(24.0f), 1e-5f);
+    ck_assert_float_eq_tol(cimagf(lu_log_determinant(f)), 0.0f, 1e-5f);
+    ck_assert_float_eq_tol(matrix_determinant(m), 24.0f, 1e-5f);
+    free_lu(f); free_matrix(m);
+    free(f); free(m);
+}
+END_TEST
+
+START_TEST(test_lu_detects_singular_matrix)
+{
+    Matrix *m = rademacher_matrix(5, 5);
+    for (int i = 0; i < 5; i++)
+        update_matrix(m, m->items[0].items[i], i, 3);
+    LU *f = lu_factorize(m);
+    ck_assert(f->singular);
+    ck_assert_float_eq(cabsf(lu_determinant(f)), 0.0f);
+    ck_assert(lu_solve(f, m) == NULL);
+    free_lu(f); free_matrix(m);
+    free(f); free(m);
+}
+END_TEST
+
+START_TEST(test_lu_solve_with_multiple_right_hand_sides)
+{
+    // Large enough for several panels
+    int n = 3 * BLOCK_SIZE + 5;
+    Matrix *a = create_diagonally_dominant_matrix(n);
+    Matrix *x = rademacher_matrix(n, 7);
+    Matrix *b = matrix_mult(a, x);
+
+    LU *f = lu_factorize(a);
+    Matrix *solution = lu_solve(f, b);
+    ck_assert_float_le(max_abs_difference(solution, x), 1e-4f);
+    free_lu(f); free_matrix(a); free_matrix(x); free_matrix(b); free_matrix(solution);
+    free(f); free(a); free(x); free(b); free(solution);
+}
+END_TEST
+
+START_TEST(test_lu_inverse_of_large_matrix)
+{
+    int n = 2 * BLOCK_SIZE + 3;
+    Matrix *a = create_diagonally_dominant_matrix(n);
+    Matrix *inv = matrix_inverse(a);
+    Matrix *prod = matrix_mult(a, inv);
+    Matrix *id = identity_matrix(n);
+    ck_assert_float_le(max_abs_difference(prod, id), 1e-4f);
+    free_matrix(a); free_matrix(inv); free_matrix(prod); free_matrix(id);
+    free(a); free(inv); free(prod); free(id);
+}
+END_TEST
+
+/**
+ * @brief Create a random complex matrix
+ * 
+ * @param rows # of rows
+ * @param cols # of columns
+ * @return Matrix* matrix with +/- 1 +/- i elements
+ */
+Matrix *create_random_complex_matrix(int rows, int cols) {
+    Matrix *re = rademacher_matrix(rows, cols);
+    Matrix *im = rademacher_matrix(rows, cols);
+    Matrix *scaled = matrix_scalar_mult(I, im);
+    Matrix *m = matrix_add(re, scaled, true);
+    free_matrix(re); free_matrix(im); free_matrix(scaled);
+    free(re); free(im); free(scaled);
+    return m;
+}
+
+/**
+ * @brief Create a random Hermitian positive-definite matrix
+ * 
+ * @param n # of rows and columns
+ * @return Matrix* B^H B + nI for a random complex B
+ */
+Matrix *create_hermitian_positive_definite_matrix(int n) {
+    Matrix *b = create_random_complex_matrix(n, n);
+    Matrix *m = matrix_gemm(1.0f, view_conj_transpose(b), view_of(b), 0.0f, NULL);
+    for (int i = 0; i < n; i++)
+        update_matrix(m, m->items[i].items[i] + n, i, i);
+    free_matrix(b);
+    free(b);
+    return m;
+}
+
+START_TEST(test_cholesky_factor_reconstructs_matrix)
+{
+    int n = 2 * BLOCK_SIZE + 9;
+    Matrix *a = create_hermitian_positive_definite_matrix(n);
+    Matrix *l = cholesky_factorize(a);
+    ck_assert_ptr_nonnull(l);
+    for (int j = 1; j < n; j++)
+        ck_assert_float_eq(cabsf(l->items[j].items[0]), 0.0f);
+
+    Matrix *lh = matrix_conj_transpose(l);
+    Matrix *prod = matrix_mult(l, lh);
+    ck_assert_float_le(max_abs_difference(prod, a) / n, 1e-4f);
+    free_matrix(a); free_matrix(l); free_matrix(lh); free_matrix(prod);
+    free(a); free(l); free(lh); free(prod);
+}
+END_TEST
+
+START_TEST(test_cholesky_solve)
+{
+    int n = BLOCK_SIZE + 17;
+    Matrix *a = create_hermitian_positive_definite_matrix(n);
+    Matrix *x = create_random_complex_matrix(n, 3);
+    Matrix *b = matrix_mult(a, x);
+
+    ck_assert_int_eq(cholesky_factorize_inplace(a), DECOMPOSITION_SUCCESS);
+    Matrix *solution = cholesky_solve(a, b);
+    ck_assert_float_le(max_abs_difference(solution, x), 1e-3f);
+    free_matrix(a); free_matrix(x); free_matrix(b); free_matrix(solution);
+    free(a); free(x); free(b); free(solution);
+}
+END_TEST
+
+START_TEST(test_cholesky_rejects_indefinite_matrix)
+{
+    Matrix *a = identity_matrix(4);
+    update_matrix(a, -1.0f, 2, 2);
+    ck_assert_ptr_null(cholesky_factorize(a));
+    free_matrix(a);
+    free(a);
+}
+END_TEST
+
+START_TEST(test_qr_factors_reconstruct_matrix)
+{
+    int rows = 2 * BLOCK_SIZE + 11, cols = BLOCK_SIZE + 30;
+    Matrix *a = create_random_complex_matrix(rows, cols);
+    QR *f = qr_factorize(a);
+    Matrix *q = qr_q(f);
+    Matrix *r = qr_r(f);
+    for (int j = 0; j < r->cols; j++)
+        for (int i = j + 1; i < r->rows; i++)
+            ck_assert_float_eq(cabsf(r->items[j].items[i]), 0.0f);
+
+    Matrix *qr = matrix_mult(q, r);
+    ck_assert_float_le(max_abs_difference(qr, a), 1e-4f);
+
+    Matrix *qh = matrix_conj_transpose(q);
+    Matrix *qhq = matrix_mult(qh, q);
+    Matrix *id = identity_matrix(cols);
+    ck_assert_float_le(max_abs_difference(qhq, id), 1e-5f);
+    free_qr(f); free_matrix(a); free_matrix(q); free_matrix(r); free_matrix(qr);
+    free_matrix(qh); free_matrix(qhq); free_matrix(id);
+    free(f); free(a); free(q); free(r); free(qr); free(qh); free(qhq); free(id);
+}
+END_TEST
+
+START_TEST(test_qr_least_squares_of_consistent_system)
+{
+    int rows = BLOCK_SIZE + 40, cols = BLOCK_SIZE + 7;
+    Matrix *a = create_random_complex_matrix(rows, cols);
+    Matrix *x = create_random_complex_matrix(cols, 2);
+    Matrix *b = matrix_mult(a, x);
+
+    QR *f = qr_factorize_inplace(a);
+    ck_assert(f->qr == a);
+    Matrix *solution = qr_least_squares(f, b);
+    ck_assert_float_le(max_abs_difference(solution, x), 1e-3f);
+    free_qr(f); free_matrix(a); free_matrix(x); free_matrix(b); free_matrix(solution);
+    free(f); free(a); free(x); free(b); free(solution);
+}
+END_TEST
@@ -0,0 +1,85 @@
+#include <check.h>
+#include "../src/eigen.h"
+
+/**
+ * @brief Get the largest residual ||A v - lambda v|| over the eigenpairs of a matrix
+ * 
+ * @param a matrix
+ * @param e eigendecomposition of a (with eigenvectors)
+ * @return float max residual norm
+ */
+float max_eigen_residual(const Matrix *a, const Eigen *e) {
+    float residual = 0.0f;
+    Matrix *av = matrix_mult(a, e->vectors);
+    for (int j = 0; j < av->cols; j++) {
+        float norm = 0.0f;
+        for (int i = 0; i < av->rows; i++) {
+            float _Complex r = av->items[j].items[i] - e->values->items[j] * e->vectors->items[j].items[i];
+            norm += crealf(r * conjf(r));
+        }
+        residual = max(residual, sqrtf(norm));
+    }
+    free_matrix(av);
+    free(av);
+    return residual;
+}
+
+START_TEST(test_eigenvalues_of_triangular_matrix)
+{
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "M", 3, 3);
+    update_matrix(m, 1 + 1*I, 0, 0); update_matrix(m, 2, 0, 1); update_matrix(m, 5, 0, 2);
+    update_matrix(m, -3, 1, 1); update_matrix(m, 7*I, 1, 2);
+    update_matrix(m, 4, 2, 2);
+    Matrix *eig = matrix_eigenvalues(m);
+    ck_assert_int_eq(eig->rows, 3);
+    for (int i = 0; i < 3; i++) {
+        float closest = INFINITY;
+        for (int j = 0; j < 3; j++)
+            closest = min(closest, cabsf(eig->items[0].items[j] - m->items[i].items[i]));
+        ck_assert_float_le(closest, 1e-5f);
+    }
+    free_matrix(m); free_matrix(eig);
+    free(m); free(eig);
+}
+END_TEST
+
+START_TEST(test_eigenpairs_of_general_matrix)
+{
+    int n = 100;
+    Matrix *a = create_random_complex_matrix(n, n);
+    Eigen *e = matrix_eigen(a, true);
+    ck_assert(e != NULL);
+    // The eigenvalues sum up to the trace
+    float _Complex sum = 0.0f;
+    for (int i = 0; i < n; i++)
+        sum += e->values->items[i];
+    ck_assert_float_le(cabsf(sum - matrix_trace(a)), 1e-2f);
+    ck_assert_float_le(max_eigen_residual(a, e), 1e-3f);
+    free_eigen(e); free_matrix(a);
+    free(e); free(a);
+}
+END_TEST
+
+START_TEST(test_hermitian_eigenpairs_are_sorted_and_orthonormal)
+{
+    int n = 80;
+    Matrix *b = create_random_complex_matrix(n, n);
+    Matrix *bh = matrix_conj_transpose(b);
+    Matrix *a = matrix_add(b, bh, true);
+    ck_assert(matrix_is_hermitian(a));
+    Eigen *e = matrix_hermitian_eigen(a, true);
+    ck_assert(e != NULL);
+    for (int i = 1; i < n; i++)
+        ck_assert_float_le(crealf(e->values->items[i-1]), crealf(e->values->items[i]));
+    ck_assert_float_le(max_eigen_residual(a, e), 1e-3f);
+
+    Matrix *vh = matrix_conj_transpose(e->vectors);
+    Matrix *gram = matrix_mult(vh, e->vectors);
+    Matrix *id = identity_matrix(n);
+    ck_assert_float_le(max_abs_difference(gram, id), 1e-4f);
+    free_eigen(e); free_matrix(a); free_matrix(b); free_matrix(bh);
+    free_matrix(vh); free_matrix(gram); free_matrix(id);
+    free(e); free(a); free(b); free(bh); free(vh); free(gram); free(id);
+}
+END_TEST
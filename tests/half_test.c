@@ -0,0 +1,86 @@
+#include <check.h>
+#include "../src/half.h"
+
+START_TEST(test_half_conversions_round_to_nearest_even)
+{
+    // Exactly representable values, the largest fp16 and the smallest subnormal
+    float exact[] = {0.0f, 1.0f, -2.5f, 65504.0f, ldexpf(1.0f, -24), -ldexpf(3.0f, -20)};
+    for (int i = 0; i < 6; i++)
+        ck_assert(half_to_float(float_to_half(exact[i], HALF_FP16), HALF_FP16) == exact[i]);
+    // Ties between two halves round to the one with an even mantissa
+    ck_assert(half_to_float(float_to_half(1.0f + ldexpf(1.0f, -11), HALF_FP16), HALF_FP16) == 1.0f);
+    ck_assert(half_to_float(float_to_half(1.0f + ldexpf(3.0f, -11), HALF_FP16), HALF_FP16) == 1.0f + ldexpf(1.0f, -9));
+    ck_assert(half_to_float(float_to_half(ldexpf(1.0f, -25), HALF_FP16), HALF_FP16) == 0.0f);
+    ck_assert(half_to_float(float_to_half(1.0f + ldexpf(1.0f, -8), HALF_BF16), HALF_BF16) == 1.0f);
+    ck_assert(half_to_float(float_to_half(1.0f + ldexpf(3.0f, -8), HALF_BF16), HALF_BF16) == 1.0f + ldexpf(1.0f, -6));
+    // fp16 overflows where bfloat16 keeps the range of float
+    ck_assert(isinf(half_to_float(float_to_half(1e5f, HALF_FP16), HALF_FP16)));
+    ck_assert(fabsf(half_to_float(float_to_half(1e30f, HALF_BF16), HALF_BF16) / 1e30f - 1.0f) < 1e-2f);
+    ck_assert(isnan(half_to_float(float_to_half(NAN, HALF_FP16), HALF_FP16)));
+    ck_assert(isnan(half_to_float(float_to_half(NAN, HALF_BF16), HALF_BF16)));
+}
+END_TEST
+
+START_TEST(test_half_round_trip_error)
+{
+    // The relative error of the rounding is at most half a unit in the last place
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "M", 300, 7);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            update_matrix(m, sinf(i + 1.0f) * (j + 1) + cosf(3.0f * i) * I, i, j);
+    HalfFormat formats[] = {HALF_FP16, HALF_BF16};
+    float unit_roundoff[] = {ldexpf(1.0f, -11), ldexpf(1.0f, -8)};
+    for (int f = 0; f < 2; f++) {
+        HalfMatrix *h = half_matrix_from_matrix(m, formats[f]);
+        Matrix *w = matrix_from_half_matrix(h);
+        for (int j = 0; j < m->cols; j++)
+            for (int i = 0; i < m->rows; i++) {
+                float _Complex x = m->items[j].items[i], y = w->items[j].items[i];
+                ck_assert(fabsf(crealf(y) - crealf(x)) <= unit_roundoff[f] * fabsf(crealf(x)));
+                ck_assert(fabsf(cimagf(y) - cimagf(x)) <= unit_roundoff[f] * fabsf(cimagf(x)));
+            }
+        free_half_matrix(h); free_matrix(w);
+        free(h); free(w);
+    }
+    free_matrix(m);
+    free(m);
+}
+END_TEST
+
+START_TEST(test_half_products_accumulate_in_float)
+{
+    // Integer entries are exact in both formats, and so are their float products
+    Matrix *a = rademacher_matrix(HALF_GEMV_ROW_BLOCK + 21, GEMM_KC + 5);
+    Matrix *b = rademacher_matrix(GEMM_KC + 5, 9);
+    for (int j = 0; j < a->cols; j += 3)
+        update_matrix(a, 2.0f * I, j % a->rows, j);
+    update_matrix(b, 1.0f - I, 4, 2);
+    Matrix *expected = matrix_gemm(2.0f, view_of(a), view_of(b), 0.0f, NULL);
+
+    HalfFormat formats[] = {HALF_FP16, HALF_BF16};
+    for (int f = 0; f < 2; f++) {
+        HalfMatrix *ha = half_matrix_from_matrix(a, formats[f]);
+        HalfMatrix *hb = half_matrix_from_matrix(b, formats[f]);
+        Matrix *c = half_matrix_gemm(2.0f, ha, hb, 0.0f, NULL);
+        for (int j = 0; j < c->cols; j++)
+            for (int i = 0; i < c->rows; i++)
+                ck_assert(c->items[j].items[i] == expected->items[j].items[i]);
+
+        // y = 2 A x - y = 2 A x for y = 2 A x
+        Vector *y = half_matrix_gemv(2.0f, ha, b->items + 2, 0.0f, NULL);
+        half_matrix_gemv(4.0f, ha, b->items + 2, -1.0f, y);
+        for (int i = 0; i < y->capacity; i++)
+            ck_assert(y->items[i] == expected->items[2].items[i]);
+
+        HalfVector *u = half_vector_from_vector(b->items + 2, formats[f]);
+        HalfVector *v = half_vector_from_vector(b->items + 3, formats[f]);
+        ck_assert(half_vector_inner_product(u, v) == vector_inner_product(b->items + 2, b->items + 3));
+        free_half_matrix(ha); free_half_matrix(hb); free_matrix(c); free_vector(y);
+        free_half_vector(u); free_half_vector(v);
+        free(ha); free(hb); free(c); free(y); free(u); free(v);
+    }
+    free_matrix(a); free_matrix(b); free_matrix(expected);
+    free(a); free(b); free(expected);
+}
+END_TEST
@@ -3,6 +3,16 @@
 #include "matrix_test.c"
 #include "tensor_test.c"
 #include "helpers_test.c"
+#include "scheduler_test.c"
+#include "decompositions_test.c"
+#include "eigen_test.c"
+#include "svd_test.c"
+#include "sparse_test.c"
+#include "randomized_test.c"
+#include "sketch_test.c"
+#include "half_test.c"
+#include "sign_test.c"
+#include "numa_test.c"
 
 Suite *vector_suite(void) {
     Suite *s = suite_create("Vector");
@@ -20,6 +30,7 @@ Suite *vector_suite(void) {
     tcase_add_test(tc_vector_operations, test_standard_vector_projection);
     tcase_add_test(tc_vector_operations, test_standard_vector_L1_norm);
     tcase_add_test(tc_vector_operations, test_standard_vector_L2_norm);
+    tcase_add_test(tc_vector_operations, test_vector_view_shares_storage);
     tcase_add_test(tc_vector_operations, test_first_level_vector_Lp_norm);
     tcase_add_test(tc_vector_operations, test_second_level_vector_Lp_norm);
     tcase_add_test(tc_vector_operations, test_third_level_vector_Lp_norm);
@@ -50,15 +61,29 @@ Suite *matrix_suite(void) {
     TCase *tc_matrix_operations = tcase_create("Matrix functions");
     tcase_add_test(tc_matrix_operations, test_empty_matrix_is_created_correctly);
     tcase_add_test(tc_matrix_operations, test_new_matrix_is_updated_correctly);
+    tcase_add_test(tc_matrix_operations, test_random_matrices_do_not_depend_on_workers);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_addition);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_subtraction);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_scalar_mult);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_multiplication);
+    tcase_add_test(tc_matrix_operations, test_fast_matrix_multiplication);
+    tcase_add_test(tc_matrix_operations, test_gemm_with_transposed_views);
+    tcase_add_test(tc_matrix_operations, test_submatrix_view_shares_storage);
+    tcase_add_test(tc_matrix_operations, test_gemm_with_real_operands);
+    tcase_add_test(tc_matrix_operations, test_thin_gemm_splits_rows);
+    tcase_add_test(tc_matrix_operations, test_gemm_3m_matches_gemm);
+    tcase_add_test(tc_matrix_operations, test_gemv_matches_gemm);
+    tcase_add_test(tc_matrix_operations, test_batched_gemv);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_power);
+    tcase_add_test(tc_matrix_operations, test_matrix_power_by_squaring);
     tcase_add_test(tc_matrix_operations, test_standard_hadamard_product);
     tcase_add_test(tc_matrix_operations, test_standard_kroenecker_product);
+    tcase_add_test(tc_matrix_operations, test_kronecker_product_of_rectangular_matrices);
     tcase_add_test(tc_matrix_operations, test_vector_tensor_prod);
     tcase_add_test(tc_matrix_operations, test_standard_transpose);
+    tcase_add_test(tc_matrix_operations, test_conj_transpose);
+    tcase_add_test(tc_matrix_operations, test_blocked_transpose_of_large_matrix);
+    tcase_add_test(tc_matrix_operations, test_inplace_transpose);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_cofactor);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_adjoint);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_inverse);
@@ -68,6 +93,8 @@ Suite *matrix_suite(void) {
     tcase_add_test(tc_matrix_operations, test_standard_matrix_L1_norm);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_Linf_norm);
     tcase_add_test(tc_matrix_operations, test_standard_matrix_frobenius_norm);
+    tcase_add_test(tc_matrix_operations, test_frobenius_norm_of_complex_matrix);
+    tcase_add_test(tc_matrix_operations, test_matrix_stats_match_individual_functions);
     suite_add_tcase(s, tc_matrix_operations);
 
     TCase *tc_matrix_helpers = tcase_create("Matrix helpers");
@@ -83,6 +110,7 @@ Suite *matrix_suite(void) {
     tcase_add_test(tc_matrix_helpers, test_stochasticity_of_non_stochastic_matrix);
     tcase_add_test(tc_matrix_helpers, test_doubly_stochasticity_of_doubly_stochastic_matrix);
     tcase_add_test(tc_matrix_helpers, test_doubly_stochasticity_of_non_doubly_stochastic_matrix);
+    tcase_add_test(tc_matrix_helpers, test_property_testers_on_large_matrices);
     suite_add_tcase(s, tc_matrix_helpers);
     return s;
 }
@@ -97,10 +125,152 @@ Suite *tensor_suite(void) {
     tcase_add_test(tc_tensor_operations, test_standard_tensor_subtraction);
     tcase_add_test(tc_tensor_operations, test_standard_tensor_scalar_multiplication);
     tcase_add_test(tc_tensor_operations, test_standard_tensor_elementwise_multiplication);
+    tcase_add_test(tc_tensor_operations, test_fused_tensor_expression);
+    tcase_add_test(tc_tensor_operations, test_fused_matrix_expression_in_place);
     suite_add_tcase(s, tc_tensor_operations);
     return s;
 }
 
+Suite *scheduler_suite(void) {
+    Suite *s = suite_create("Scheduler");
+
+    TCase *tc_scheduler = tcase_create("Scheduler functions");
+    tcase_add_test(tc_scheduler, test_all_spawned_tasks_are_run);
+    tcase_add_test(tc_scheduler, test_nested_spawns_are_synchronised);
+    tcase_add_test(tc_scheduler, test_parallel_for_visits_each_index_once);
+    suite_add_tcase(s, tc_scheduler);
+    return s;
+}
+
+Suite *decompositions_suite(void) {
+    Suite *s = suite_create("Decompositions");
+
+    TCase *tc_lu = tcase_create("LU factorization");
+    tcase_add_test(tc_lu, test_lu_determinant_of_permuted_matrix);
+    tcase_add_test(tc_lu, test_lu_detects_singular_matrix);
+    tcase_add_test(tc_lu, test_lu_solve_with_multiple_right_hand_sides);
+    tcase_add_test(tc_lu, test_lu_inverse_of_large_matrix);
+    suite_add_tcase(s, tc_lu);
+
+    TCase *tc_cholesky = tcase_create("Cholesky factorization");
+    tcase_add_test(tc_cholesky, test_cholesky_factor_reconstructs_matrix);
+    tcase_add_test(tc_cholesky, test_cholesky_solve);
+    tcase_add_test(tc_cholesky, test_cholesky_rejects_indefinite_matrix);
+    suite_add_tcase(s, tc_cholesky);
+
+    TCase *tc_qr = tcase_create("QR factorization");
+    tcase_add_test(tc_qr, test_qr_factors_reconstruct_matrix);
+    tcase_add_test(tc_qr, test_qr_least_squares_of_consistent_system);
+    suite_add_tcase(s, tc_qr);
+    return s;
+}
+
+Suite *eigen_suite(void) {
+    Suite *s = suite_create("Eigen");
+
+    TCase *tc_eigen = tcase_create("Eigendecomposition");
+    tcase_add_test(tc_eigen, test_eigenvalues_of_triangular_matrix);
+    tcase_add_test(tc_eigen, test_eigenpairs_of_general_matrix);
+    tcase_add_test(tc_eigen, test_hermitian_eigenpairs_are_sorted_and_orthonormal);
+    suite_add_tcase(s, tc_eigen);
+    return s;
+}
+
+Suite *svd_suite(void) {
+    Suite *s = suite_create("SVD");
+
+    TCase *tc_svd = tcase_create("Singular value decomposition");
+    tcase_add_test(tc_svd, test_svd_of_tall_matrix);
+    tcase_add_test(tc_svd, test_svd_of_wide_matrix);
+    tcase_add_test(tc_svd, test_randomized_svd_of_low_rank_matrix);
+    suite_add_tcase(s, tc_svd);
+    return s;
+}
+
+Suite *sparse_suite(void) {
+    Suite *s = suite_create("Sparse");
+
+    TCase *tc_sparse_matrix = tcase_create("Sparse matrix functions");
+    tcase_add_test(tc_sparse_matrix, test_sparse_dense_round_trip);
+    tcase_add_test(tc_sparse_matrix, test_sparse_transpose);
+    tcase_add_test(tc_sparse_matrix, test_sparse_matrix_vector_product);
+    tcase_add_test(tc_sparse_matrix, test_sparse_matrix_dense_matrix_product);
+    suite_add_tcase(s, tc_sparse_matrix);
+
+    TCase *tc_sparse_vector = tcase_create("Sparse vector functions");
+    tcase_add_test(tc_sparse_vector, test_sparse_vector_from_unsorted_arrays);
+    tcase_add_test(tc_sparse_vector, test_sparse_dense_inner_product_and_norms);
+    tcase_add_test(tc_sparse_vector, test_sparse_sparse_inner_product);
+    suite_add_tcase(s, tc_sparse_vector);
+    return s;
+}
+
+Suite *randomized_suite(void) {
+    Suite *s = suite_create("Randomized");
+
+    TCase *tc_sampling = tcase_create("Sampling-based estimators");
+    tcase_add_test(tc_sampling, test_sampling_follows_weights);
+    tcase_add_test(tc_sampling, test_approximate_matrix_mult);
+    tcase_add_test(tc_sampling, test_hutchinson_trace);
+    tcase_add_test(tc_sampling, test_hutchpp_trace_of_low_rank_matrix);
+    tcase_add_test(tc_sampling, test_frobenius_norm_estimates);
+    tcase_add_test(tc_sampling, test_spectral_norm_and_condition_number);
+    suite_add_tcase(s, tc_sampling);
+
+    return s;
+}
+
+Suite *sketch_suite(void) {
+    Suite *s = suite_create("Sketch");
+
+    TCase *tc_frequent_directions = tcase_create("Frequent Directions");
+    tcase_add_test(tc_frequent_directions, test_frequent_directions_bound);
+    tcase_add_test(tc_frequent_directions, test_merged_frequent_directions);
+    suite_add_tcase(s, tc_frequent_directions);
+
+    TCase *tc_sign_sketch = tcase_create("Sign sketch");
+    tcase_add_test(tc_sign_sketch, test_sign_sketch_preserves_norms);
+    suite_add_tcase(s, tc_sign_sketch);
+
+    return s;
+}
+
+Suite *half_suite(void) {
+    Suite *s = suite_create("Half");
+
+    TCase *tc_half_precision = tcase_create("Half precision");
+    tcase_add_test(tc_half_precision, test_half_conversions_round_to_nearest_even);
+    tcase_add_test(tc_half_precision, test_half_round_trip_error);
+    tcase_add_test(tc_half_precision, test_half_products_accumulate_in_float);
+    suite_add_tcase(s, tc_half_precision);
+
+    return s;
+}
+
+Suite *sign_suite(void) {
+    Suite *s = suite_create("Sign");
+
+    TCase *tc_sign_matrices = tcase_create("Sign matrices");
+    tcase_add_test(tc_sign_matrices, test_rademacher_sign_matrix_matches_dense);
+    tcase_add_test(tc_sign_matrices, test_sign_matrix_products);
+    tcase_add_test(tc_sign_matrices, test_integer_product_of_sign_matrices);
+    suite_add_tcase(s, tc_sign_matrices);
+
+    return s;
+}
+
+Suite *numa_suite(void) {
+    Suite *s = suite_create("NUMA");
+
+    TCase *tc_allocation_policies = tcase_create("Allocation policies");
+    tcase_add_test(tc_allocation_policies, test_allocation_policies_zero_fill);
+    tcase_add_test(tc_allocation_policies, test_memory_nodes);
+    tcase_add_test(tc_allocation_policies, test_bound_pages_follow_the_policy);
+    suite_add_tcase(s, tc_allocation_policies);
+
+    return s;
+}
+
 Suite *helpers_suite(void) {
     Suite *s = suite_create("Helpers");
 
@@ -116,22 +286,72 @@ int main(void) {
     Suite *s_matrix = matrix_suite();
     Suite *s_tensor = tensor_suite();
     Suite *s_helpers = helpers_suite();
+    Suite *s_scheduler = scheduler_suite();
+    Suite *s_decompositions = decompositions_suite();
+    Suite *s_eigen = eigen_suite();
+    Suite *s_svd = svd_suite();
+    Suite *s_sparse = sparse_suite();
+    Suite *s_randomized = randomized_suite();
+    Suite *s_sketch = sketch_suite();
+    Suite *s_half = half_suite();
+    Suite *s_sign = sign_suite();
+    Suite *s_numa = numa_suite();
     SRunner *sr_vector = srunner_create(s_vector);
     SRunner *sr_matrix = srunner_create(s_matrix);
     SRunner *sr_tensor = srunner_create(s_tensor);
     SRunner *sr_helpers = srunner_create(s_helpers);
+    SRunner *sr_scheduler = srunner_create(s_scheduler);
+    SRunner *sr_decompositions = srunner_create(s_decompositions);
+    SRunner *sr_eigen = srunner_create(s_eigen);
+    SRunner *sr_svd = srunner_create(s_svd);
+    SRunner *sr_sparse = srunner_create(s_sparse);
+    SRunner *sr_randomized = srunner_create(s_randomized);
+    SRunner *sr_sketch = srunner_create(s_sketch);
+    SRunner *sr_half = srunner_create(s_half);
+    SRunner *sr_sign = srunner_create(s_sign);
+    SRunner *sr_numa = srunner_create(s_numa);
 
     srunner_run_all(sr_vector, CK_NORMAL);
     srunner_run_all(sr_matrix, CK_NORMAL);
     srunner_run_all(sr_tensor, CK_NORMAL);
     srunner_run_all(sr_helpers, CK_NORMAL);
+    srunner_run_all(sr_scheduler, CK_NORMAL);
+    srunner_run_all(sr_decompositions, CK_NORMAL);
+    srunner_run_all(sr_eigen, CK_NORMAL);
+    srunner_run_all(sr_svd, CK_NORMAL);
+    srunner_run_all(sr_sparse, CK_NORMAL);
+    srunner_run_all(sr_randomized, CK_NORMAL);
+    srunner_run_all(sr_sketch, CK_NORMAL);
+    srunner_run_all(sr_half, CK_NORMAL);
+    srunner_run_all(sr_sign, CK_NORMAL);
+    srunner_run_all(sr_numa, CK_NORMAL);
     nb_fails = srunner_ntests_failed(sr_vector) \
         + srunner_ntests_failed(sr_matrix) \
         + srunner_ntests_failed(sr_tensor) \
-        + srunner_ntests_failed(sr_helpers);
+        + srunner_ntests_failed(sr_helpers) \
+        + srunner_ntests_failed(sr_scheduler) \
+        + srunner_ntests_failed(sr_decompositions) \
+        + srunner_ntests_failed(sr_eigen) \
+        + srunner_ntests_failed(sr_svd) \
+        + srunner_ntests_failed(sr_sparse) \
+        + srunner_ntests_failed(sr_randomized) \
+        + srunner_ntests_failed(sr_sketch) \
+        + srunner_ntests_failed(sr_half) \
+        + srunner_ntests_failed(sr_sign) \
+        + srunner_ntests_failed(sr_numa);
     srunner_free(sr_vector);
     srunner_free(sr_matrix);
     srunner_free(sr_tensor);
     srunner_free(sr_helpers);
+    srunner_free(sr_scheduler);
+    srunner_free(sr_decompositions);
+    srunner_free(sr_eigen);
+    srunner_free(sr_svd);
+    srunner_free(sr_sparse);
+    srunner_free(sr_randomized);
+    srunner_free(sr_sketch);
+    srunner_free(sr_half);
+    srunner_free(sr_sign);
+    srunner_free(sr_numa);
     return (nb_fails == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
@@ -109,6 +109,33 @@ START_TEST(test_new_matrix_is_updated_correctly)
 }
 END_TEST
 
+START_TEST(test_random_matrices_do_not_depend_on_workers)
+{
+    // Column counts that make parallel_for split inside blocks of GEMM_NC columns
+    Matrix *r[2], *g[2];
+    int workers[2] = {1, 4};
+    for (int w = 0; w < 2; w++) {
+        scheduler_shutdown();
+        scheduler_init(workers[w]);
+        srand(11);
+        r[w] = rademacher_matrix(70, 3 * GEMM_NC + 5);
+        g[w] = gaussian_matrix(70, 3 * GEMM_NC + 5);
+    }
+    scheduler_shutdown();
+    for (int j = 0; j < r[0]->cols; j++)
+        for (int i = 0; i < r[0]->rows; i++) {
+            ck_assert(r[0]->items[j].items[i] == r[1]->items[j].items[i]);
+            ck_assert(g[0]->items[j].items[i] == g[1]->items[j].items[i]);
+        }
+    // Distinct blocks draw from distinct streams
+    ck_assert(memcmp(g[0]->items[0].items, g[0]->items[GEMM_NC].items, 70 * sizeof(float _Complex)) != 0);
+    for (int w = 0; w < 2; w++) {
+        free_matrix(r[w]); free_matrix(g[w]);
+        free(r[w]); free(g[w]);
+    }
+}
+END_TEST
+
 START_TEST(test_standard_matrix_addition)
 {
     Matrix *m1 = create_dummy_real_matrix(1.0f);
@@ -164,6 +191,22 @@ START_TEST(test_standard_matrix_multiplication)
 }
 END_TEST
 
+START_TEST(test_fast_matrix_multiplication)
+{
+    // Large enough for two levels of Strassen recursion
+    Matrix *m1 = rademacher_matrix(4 * THRESHOLD, 4 * THRESHOLD);
+    Matrix *m2 = rademacher_matrix(4 * THRESHOLD, 4 * THRESHOLD);
+    
+    Matrix *expected = matrix_mult(m1, m2);
+    Matrix *m = fast_matrix_mult(m1, m2);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            ck_assert_float_eq(m->items[j].items[i], expected->items[j].items[i]);
+    free_matrix(m1); free_matrix(m2); free_matrix(expected); free_matrix(m);
+    free(m1); free(m2); free(expected); free(m);
+}
+END_TEST
+
 START_TEST(test_standard_matrix_power)
 {
     Matrix *m = create_dummy_real_matrix(2.0f);
@@ -176,6 +219,38 @@ START_TEST(test_standard_matrix_power)
 }
 END_TEST
 
+START_TEST(test_matrix_power_by_squaring)
+{
+    Matrix *m = rademacher_matrix(6, 6);
+    Matrix *expected = identity_matrix(6);
+    Matrix *id = matrix_power(m, 0);
+    for (int j = 0; j < 6; j++)
+        for (int i = 0; i < 6; i++)
+            ck_assert(id->items[j].items[i] == expected->items[j].items[i]);
+    // Entries of A^9 and A^9 v are bounded by 6^8 and 6^9, below 2^24: floats hold them
+    // exactly, whatever the order of the products
+    for (int p = 1; p <= 9; p++) {
+        Matrix *next = matrix_mult(expected, m);
+        free_matrix(expected);
+        free(expected);
+        expected = next;
+    }
+    Matrix *pow = matrix_power(m, 9);
+    for (int j = 0; j < 6; j++)
+        for (int i = 0; i < 6; i++)
+            ck_assert(pow->items[j].items[i] == expected->items[j].items[i]);
+
+    Vector *v = rademacher_vector(6);
+    Vector *w = matrix_power_vector(m, 9, v);
+    Vector *expected_w = matrix_gemv(1.0f, view_of(expected), v, 0.0f, NULL);
+    for (int i = 0; i < 6; i++)
+        ck_assert(w->items[i] == expected_w->items[i]);
+    free_matrix(m); free_matrix(expected); free_matrix(id); free_matrix(pow);
+    free_vector(v); free_vector(w); free_vector(expected_w);
+    free(m); free(expected); free(id); free(pow); free(v); free(w); free(expected_w);
+}
+END_TEST
+
 START_TEST(test_standard_hadamard_product)
 {
     Matrix *m1 = create_dummy_real_matrix(1.0f);
@@ -206,6 +281,29 @@ START_TEST(test_standard_kroenecker_product)
 }
 END_TEST
 
+START_TEST(test_kronecker_product_of_rectangular_matrices)
+{
+    Matrix *a = rademacher_matrix(2, 3);
+    Matrix *b = rademacher_matrix(4, 5);
+    update_matrix(a, 3.0f * I, 1, 2);
+    Matrix *k = matrix_kronecker_prod(a, b);
+    ck_assert_int_eq(k->rows, 8);
+    ck_assert_int_eq(k->cols, 15);
+    for (int j = 0; j < k->cols; j++)
+        for (int i = 0; i < k->rows; i++)
+            ck_assert(k->items[j].items[i] == a->items[j / 5].items[i / 4] * b->items[j % 5].items[i % 4]);
+
+    // The lazy operator agrees with the explicit product
+    Vector *x = rademacher_vector(15);
+    Vector *expected = matrix_gemv(1.0f, view_of(k), x, 0.0f, NULL);
+    Vector *y = kronecker_mult_vector(a, b, x);
+    for (int i = 0; i < 8; i++)
+        ck_assert(y->items[i] == expected->items[i]);
+    free_matrix(a); free_matrix(b); free_matrix(k); free_vector(x); free_vector(expected); free_vector(y);
+    free(a); free(b); free(k); free(x); free(expected); free(y);
+}
+END_TEST
+
 START_TEST(test_vector_tensor_prod)
 {
     Vector *u = create_dummy_real_vector(1.0f);
@@ -223,6 +321,181 @@ START_TEST(test_vector_tensor_prod)
 }
 END_TEST
 
+START_TEST(test_gemm_with_transposed_views)
+{
+    // Sizes spanning several packed blocks, with leftover columns
+    Matrix *a = rademacher_matrix(GEMM_KC + 3, GEMM_MC + 9);
+    Matrix *b = rademacher_matrix(GEMM_NC + 6, GEMM_KC + 3);
+    for (int i = 0; i < b->rows; i++)
+        update_matrix(b, b->items[0].items[i] * I, i, 0);
+    Matrix *ah = matrix_conj_transpose(a);
+    Matrix *bt = matrix_transpose(b);
+    Matrix *expected = matrix_mult(ah, bt);
+
+    Matrix *c = matrix_gemm(1.0f, view_conj_transpose(a), view_transpose(b), 0.0f, NULL);
+    for (int j = 0; j < c->cols; j++)
+        for (int i = 0; i < c->rows; i++)
+            ck_assert(c->items[j].items[i] == expected->items[j].items[i]);
+    // C = 2 A^H B^T - C = A^H B^T
+    matrix_gemm(2.0f, view_conj_transpose(a), view_transpose(b), -1.0f, c);
+    for (int j = 0; j < c->cols; j++)
+        for (int i = 0; i < c->rows; i++)
+            ck_assert(c->items[j].items[i] == expected->items[j].items[i]);
+    free_matrix(a); free_matrix(b); free_matrix(ah); free_matrix(bt); free_matrix(expected); free_matrix(c);
+    free(a); free(b); free(ah); free(bt); free(expected); free(c);
+}
+END_TEST
+
+// Reference product computed element by element
+static void assert_product_equals(const Matrix *c, float _Complex alpha, const Matrix *a, const Matrix *b) {
+    for (int j = 0; j < c->cols; j++)
+        for (int i = 0; i < c->rows; i++) {
+            float _Complex sum = 0.0f;
+            for (int k = 0; k < a->cols; k++)
+                sum += a->items[k].items[i] * b->items[j].items[k];
+            ck_assert(c->items[j].items[i] == alpha * sum);
+        }
+}
+
+START_TEST(test_gemm_with_real_operands)
+{
+    Matrix *a = rademacher_matrix(GEMM_MC + 9, GEMM_KC + 3);
+    Matrix *b = rademacher_matrix(GEMM_KC + 3, 11);
+    Matrix *c = matrix_gemm(1.0f, view_of(a), view_of(b), 0.0f, NULL);
+    assert_product_equals(c, 1.0f, a, b);
+    // A complex scalar only makes the real product complex when it is added to C
+    matrix_gemm(2.0f * I, view_of(a), view_of(b), 0.0f, c);
+    assert_product_equals(c, 2.0f * I, a, b);
+
+    // Real operand times complex operand, either way round
+    Matrix *z = rademacher_matrix(GEMM_KC + 3, 11);
+    for (int j = 0; j < z->cols; j++)
+        update_matrix(z, z->items[j].items[j] * I, j, j);
+    matrix_gemm(1.0f, view_of(a), view_of(z), 0.0f, c);
+    assert_product_equals(c, 1.0f, a, z);
+    Matrix *w = rademacher_matrix(GEMM_MC + 9, GEMM_KC + 3);
+    update_matrix(w, I, 3, GEMM_KC + 1);
+    matrix_gemm(1.0f, view_of(w), view_of(b), 0.0f, c);
+    assert_product_equals(c, 1.0f, w, b);
+    free_matrix(a); free_matrix(b); free_matrix(c); free_matrix(z); free_matrix(w);
+    free(a); free(b); free(c); free(z); free(w);
+}
+END_TEST
+
+START_TEST(test_thin_gemm_splits_rows)
+{
+    // Fewer columns than GEMM_NC: the rows of C are split across the workers
+    scheduler_shutdown();
+    scheduler_init(4);
+    Matrix *a = rademacher_matrix(7 * GEMM_MC + 9, GEMM_KC + 3);
+    Matrix *b = rademacher_matrix(GEMM_KC + 3, 5);
+    update_matrix(b, 1.0f + I, 2, 3);
+    Matrix *c = matrix_gemm(1.0f, view_of(a), view_of(b), 0.0f, NULL);
+    // C = 2 A B - C = A B, every tile scaling its own rows
+    matrix_gemm(2.0f, view_of(a), view_of(b), -1.0f, c);
+    assert_product_equals(c, 1.0f, a, b);
+    matrix_gemm_3m(1.0f, view_of(a), view_of(b), 0.0f, c);
+    assert_product_equals(c, 1.0f, a, b);
+    scheduler_shutdown();
+    free_matrix(a); free_matrix(b); free_matrix(c);
+    free(a); free(b); free(c);
+}
+END_TEST
+
+START_TEST(test_gemm_3m_matches_gemm)
+{
+    // Integer entries: both methods are exact, whatever the order of the operations
+    Matrix *a = rademacher_matrix(GEMM_KC + 3, GEMM_MC + 9);
+    Matrix *b = rademacher_matrix(GEMM_NC + 6, GEMM_KC + 3);
+    for (int j = 0; j < a->cols; j++)
+        for (int i = j % 3; i < a->rows; i += 3)
+            update_matrix(a, a->items[j].items[i] * (1.0f - 2.0f * I), i, j);
+    for (int j = 0; j < b->cols; j += 2)
+        for (int i = 0; i < b->rows; i++)
+            update_matrix(b, b->items[j].items[i] * (2.0f + I), i, j);
+
+    Matrix *expected = matrix_gemm(1.0f - I, view_conj_transpose(a), view_transpose(b), 0.0f, NULL);
+    Matrix *c = matrix_gemm_3m(1.0f - I, view_conj_transpose(a), view_transpose(b), 0.0f, NULL);
+    for (int j = 0; j < c->cols; j++)
+        for (int i = 0; i < c->rows; i++)
+            ck_assert(c->items[j].items[i] == expected->items[j].items[i]);
+    // C = 2 (1 - i) A^H B^T - C = (1 - i) A^H B^T
+    matrix_gemm_3m(2.0f - 2.0f * I, view_conj_transpose(a), view_transpose(b), -1.0f, c);
+    for (int j = 0; j < c->cols; j++)
+        for (int i = 0; i < c->rows; i++)
+            ck_assert(c->items[j].items[i] == expected->items[j].items[i]);
+    free_matrix(a); free_matrix(b); free_matrix(expected); free_matrix(c);
+    free(a); free(b); free(expected); free(c);
+}
+END_TEST
+
+START_TEST(test_gemv_matches_gemm)
+{
+    Matrix *a = rademacher_matrix(GEMV_ROW_BLOCK + 37, 23);
+    Matrix *x = rademacher_matrix(23, 1);
+    Matrix *z = rademacher_matrix(GEMV_ROW_BLOCK + 37, 1);
+    for (int i = 0; i < a->rows; i += 3)
+        update_matrix(a, a->items[i % 23].items[i] * I, i, i % 23);
+    update_matrix(x, 2.0f * I, 5, 0);
+
+    Matrix *ax = matrix_gemm(1.0f, view_of(a), view_of(x), 0.0f, NULL);
+    Vector *y = matrix_gemv(1.0f, view_of(a), &x->items[0], 0.0f, NULL);
+    for (int i = 0; i < a->rows; i++)
+        ck_assert(y->items[i] == ax->items[0].items[i]);
+
+    // y = 2 A^H z - y
+    Matrix *ahz = matrix_gemm(1.0f, view_conj_transpose(a), view_of(z), 0.0f, NULL);
+    Vector *w = matrix_gemv(1.0f, view_conj_transpose(a), &z->items[0], 0.0f, NULL);
+    matrix_gemv(2.0f, view_conj_transpose(a), &z->items[0], -1.0f, w);
+    for (int i = 0; i < a->cols; i++)
+        ck_assert(w->items[i] == ahz->items[0].items[i]);
+    free_matrix(a); free_matrix(x); free_matrix(z); free_matrix(ax); free_matrix(ahz);
+    free_vector(y); free_vector(w);
+    free(a); free(x); free(z); free(ax); free(ahz); free(y); free(w);
+}
+END_TEST
+
+START_TEST(test_batched_gemv)
+{
+    Matrix *a = rademacher_matrix(50, 40);
+    Matrix *x = rademacher_matrix(40, 6);
+    Vector *ys = matrix_gemv_batched(1.0f, view_of(a), x->items, 6);
+    for (int k = 0; k < 6; k++) {
+        Vector *y = matrix_gemv(1.0f, view_of(a), &x->items[k], 0.0f, NULL);
+        for (int i = 0; i < 50; i++)
+            ck_assert(ys[k].items[i] == y->items[i]);
+        free_vector(y); free_vector(&ys[k]);
+        free(y);
+    }
+    free_matrix(a); free_matrix(x);
+    free(a); free(x); free(ys);
+}
+END_TEST
+
+START_TEST(test_submatrix_view_shares_storage)
+{
+    Matrix *m = rademacher_matrix(40, 30);
+    Matrix view;
+    init_matrix_view(&view, m, 5, 25, 10, 22);
+    ck_assert_int_eq(view.rows, 20);
+    ck_assert_int_eq(view.cols, 12);
+    ck_assert(view.items[3].items[4] == m->items[13].items[9]);
+
+    // Kernels take views like any matrix, and writes go through to m
+    Matrix *copy = create_submatrix(m, 5, 25, 10, 22);
+    Matrix *expected = matrix_gemm(1.0f, view_transpose(copy), view_of(copy), 0.0f, NULL);
+    Matrix *product = matrix_gemm(1.0f, view_transpose(&view), view_of(&view), 0.0f, NULL);
+    for (int j = 0; j < 12; j++)
+        for (int i = 0; i < 12; i++)
+            ck_assert(product->items[j].items[i] == expected->items[j].items[i]);
+    update_matrix(&view, 7.0f, 0, 0);
+    ck_assert(m->items[10].items[5] == 7.0f);
+    free_matrix_view(&view);
+    free_matrix(m); free_matrix(copy); free_matrix(expected); free_matrix(product);
+    free(m); free(copy); free(expected); free(product);
+}
+END_TEST
+
 START_TEST(test_standard_transpose)
 {
     float _Complex vals[2] = {0.0f, 1.0f};
@@ -251,6 +524,51 @@ START_TEST(test_conj_transpose)
 }
 END_TEST
 
+START_TEST(test_blocked_transpose_of_large_matrix)
+{
+    // Dimensions that are not multiples of the tile nor of the SIMD blocks
+    Matrix *m = rademacher_matrix(131, 77);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            update_matrix(m, m->items[j].items[i] + (float) (i - j) * I, i, j);
+
+    Matrix *t = matrix_transpose(m);
+    Matrix *h = matrix_conj_transpose(m);
+    ck_assert_int_eq(t->rows, 77);
+    ck_assert_int_eq(t->cols, 131);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++) {
+            ck_assert(t->items[i].items[j] == m->items[j].items[i]);
+            ck_assert(h->items[i].items[j] == conjf(m->items[j].items[i]));
+        }
+    free_matrix(m); free_matrix(t); free_matrix(h);
+    free(m); free(t); free(h);
+}
+END_TEST
+
+START_TEST(test_inplace_transpose)
+{
+    Matrix *m = rademacher_matrix(103, 103);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            update_matrix(m, m->items[j].items[i] + (float) (2 * i + j) * I, i, j);
+    Matrix *expected = matrix_conj_transpose(m);
+
+    matrix_transpose_inplace(m, true);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            ck_assert(m->items[j].items[i] == expected->items[j].items[i]);
+    // Transposing twice gives back the original matrix
+    matrix_transpose_inplace(m, false);
+    matrix_transpose_inplace(m, false);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            ck_assert(m->items[j].items[i] == expected->items[j].items[i]);
+    free_matrix(m); free_matrix(expected);
+    free(m); free(expected);
+}
+END_TEST
+
 START_TEST(test_standard_matrix_cofactor)
 {
     Matrix *m = create_dummy_real_matrix(1.0f);
@@ -354,6 +672,62 @@ START_TEST(test_standard_matrix_frobenius_norm)
 }
 END_TEST
 
+START_TEST(test_frobenius_norm_of_complex_matrix)
+{
+    Matrix *m = malloc(sizeof(Matrix));
+    init_matrix(m, "M", 2, 2);
+    update_matrix(m, 3.0f * I, 0, 0);
+    update_matrix(m, 1.0f - 1.0f * I, 1, 1);
+    ck_assert_float_eq_tol(matrix_frobenius_norm(m), sqrtf(11.0f), 1e-6f);
+    free_matrix(m);
+    free(m);
+}
+END_TEST
+
+START_TEST(test_matrix_stats_match_individual_functions)
+{
+    // Elements +-1 +-i: complex, hence not integral, all of magnitude sqrt(2)
+    Matrix *re = rademacher_matrix(150, 150), *im = rademacher_matrix(150, 150);
+    Matrix *scaled = matrix_scalar_mult(I, im);
+    Matrix *m = matrix_add(re, scaled, true);
+    MatrixStats *s = matrix_stats(m);
+    ck_assert_float_eq_tol(s->L1_norm, matrix_L1_norm(m), 1e-3f);
+    ck_assert_float_eq_tol(s->Linf_norm, matrix_Linf_norm(m), 1e-3f);
+    ck_assert_float_eq_tol(s->frobenius_norm, 150.0f * sqrtf(2.0f), 1e-3f);
+    ck_assert_float_le(cabsf(s->trace - matrix_trace(m)), 1e-4f);
+    ck_assert_float_eq_tol(s->max_abs, sqrtf(2.0f), 1e-6f);
+    ck_assert_float_eq_tol(s->min_abs, sqrtf(2.0f), 1e-6f);
+    ck_assert(!s->is_real);
+    ck_assert(!s->is_integral);
+    for (int i = 0; i < 150; i++)
+        ck_assert_float_eq_tol(s->row_sums[i], 150.0f * sqrtf(2.0f), 1e-3f);
+    free_matrix_stats(s);
+    free(s);
+    s = matrix_stats(re);
+    ck_assert(s->is_real);
+    ck_assert(s->is_integral);
+    free_matrix_stats(s);
+    free(s);
+
+    // A wide real matrix with fractional elements
+    Matrix *g = gaussian_matrix(40, 300);
+    update_matrix(g, 0.0f, 7, 123);
+    s = matrix_stats(g);
+    ck_assert(s->is_real);
+    ck_assert(!s->is_integral);
+    ck_assert_float_eq(s->min_abs, 0.0f);
+    ck_assert_float_eq(crealf(s->trace), 0.0f);
+    ck_assert_float_eq_tol(s->L1_norm, matrix_L1_norm(g), 1e-3f * s->L1_norm);
+    ck_assert_float_eq_tol(s->Linf_norm, matrix_Linf_norm(g), 1e-3f * s->Linf_norm);
+    ck_assert_float_eq_tol(s->frobenius_norm, matrix_frobenius_norm(g), 1e-3f * s->frobenius_norm);
+    free_matrix_stats(s);
+    free(s);
+
+    free_matrix(re); free_matrix(im); free_matrix(scaled); free_matrix(m); free_matrix(g);
+    free(re); free(im); free(scaled); free(m); free(g);
+}
+END_TEST
+
 START_TEST(test_symmetry_of_symmetric_matrix)
 {
     Matrix *m = create_dummy_real_matrix(1.0f);
@@ -429,6 +803,45 @@ START_TEST(test_matrix_of_floats)
 }
 END_TEST
 
+START_TEST(test_property_testers_on_large_matrices)
+{
+    int n = 400;
+    Matrix *m = rademacher_matrix(n, n);
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < j; i++)
+            update_matrix(m, m->items[i].items[j], i, j);
+    ck_assert(matrix_is_symmetric(m));
+    ck_assert(matrix_probably_symmetric(m, 0.05f));
+    // Half of the elements above the diagonal no longer match their mirror
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < j; i += 2)
+            update_matrix(m, -m->items[j].items[i], i, j);
+    ck_assert(!matrix_is_symmetric(m));
+    ck_assert(!matrix_probably_symmetric(m, 0.1f));
+
+    Matrix *d = identity_matrix(n);
+    ck_assert(matrix_is_diagonal(d));
+    ck_assert(matrix_probably_diagonal(d, 0.05f));
+    ck_assert(!matrix_probably_diagonal(m, 0.1f));
+
+    // A cyclic permutation is doubly stochastic, until half of its columns are doubled
+    Matrix *p = malloc(sizeof(Matrix));
+    init_matrix(p, "P", n, n);
+    for (int j = 0; j < n; j++)
+        update_matrix(p, 1.0f, (j + 1) % n, j);
+    ck_assert(matrix_is_doubly_stochastic(p));
+    ck_assert(matrix_probably_doubly_stochastic(p, 0.05f));
+    for (int j = 0; j < n; j += 2)
+        update_matrix(p, 2.0f, (j + 1) % n, j);
+    ck_assert(!matrix_is_stochastic(p));
+    ck_assert(!matrix_probably_stochastic(p, 0.1f));
+    ck_assert(!matrix_probably_doubly_stochastic(p, 0.1f));
+
+    free_matrix(m); free_matrix(d); free_matrix(p);
+    free(m); free(d); free(p);
+}
+END_TEST
+
 START_TEST(test_stochasticity_of_stochastic_matrix)
 {
     Matrix *m = create_stochastic_matrix();
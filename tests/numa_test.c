@@ -0,0 +1,103 @@
+#include <check.h>
+#include "../src/numa.h"
+#ifdef __linux__
+    #include <unistd.h>
+    #include <sys/syscall.h>
+#endif
+
+START_TEST(test_allocation_policies_zero_fill)
+{
+    AllocPolicy policies[] = {ALLOC_FIRST_TOUCH, ALLOC_INTERLEAVED, ALLOC_NODE_BOUND, ALLOC_LOCAL};
+    for (int p = 0; p < 4; p++) {
+        set_alloc_policy(policies[p], 0);
+        ck_assert_int_eq(get_alloc_policy(), policies[p]);
+        // Tall enough for the columns to be split in blocks, wide enough for several
+        // column blocks
+        Matrix *m = malloc(sizeof(Matrix));
+        init_matrix(m, "M", 3 * FIRST_TOUCH_ROW_BLOCK + 5, 2 * GEMM_NC + 3);
+        for (int j = 0; j < m->cols; j++)
+            for (int i = 0; i < m->rows; i++)
+                ck_assert(m->items[j].items[i] == 0.0f);
+        Vector *v = malloc(sizeof(Vector));
+        ck_assert_int_eq(init_vector(v, "V", 5 * FIRST_TOUCH_ROW_BLOCK + 1), VECTOR_SUCCESS);
+        for (int i = 0; i < v->capacity; i++)
+            ck_assert(v->items[i] == 0.0f);
+        Tensor *t = malloc(sizeof(Tensor));
+        init_tensor(t, "T", FIRST_TOUCH_ROW_BLOCK + 1, 3, 2);
+        for (int d = 0; d < t->depth; d++)
+            for (int j = 0; j < t->cols; j++)
+                for (int i = 0; i < t->rows; i++)
+                    ck_assert(t->items[d].items[j].items[i] == 0.0f);
+        free_matrix(m); free_vector(v); free_tensor(t);
+        free(m); free(v); free(t);
+    }
+    ck_assert_int_eq(get_alloc_policy(), ALLOC_LOCAL);
+}
+END_TEST
+
+// Lines of /proc/self/maps, i.e. memory mappings of the process
+static int count_mappings(void) {
+    FILE *f = fopen("/proc/self/maps", "r");
+    if (f == NULL)
+        return 0;
+    int lines = 0;
+    for (int c = fgetc(f); c != EOF; c = fgetc(f))
+        lines += c == '\n';
+    fclose(f);
+    return lines;
+}
+
+START_TEST(test_memory_nodes)
+{
+    ck_assert_int_ge(numa_node_count(), 1);
+    set_alloc_policy(ALLOC_INTERLEAVED, 0);
+    size_t bytes = 1 << 20;
+    char *p = map_buffer(bytes);
+    ck_assert(p != NULL);
+#ifdef __linux__
+    ck_assert_int_eq(place_buffer(p, bytes), 0);
+#endif
+    zero_fill(p, bytes, 1);
+    for (size_t i = 0; i < bytes; i++)
+        ck_assert_int_eq(p[i], 0);
+    unmap_buffer(p, bytes);
+    set_alloc_policy(ALLOC_LOCAL, 0);
+}
+END_TEST
+
+START_TEST(test_bound_pages_follow_the_policy)
+{
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    // Modes of get_mempolicy
+    const int MPOL_DEFAULT = 0, MPOL_BIND = 2, MPOL_INTERLEAVE = 3, MPOL_F_ADDR = 2;
+    AllocPolicy policies[] = {ALLOC_NODE_BOUND, ALLOC_INTERLEAVED};
+    int modes[] = {MPOL_BIND, MPOL_INTERLEAVE};
+    for (int k = 0; k < 2; k++) {
+        set_alloc_policy(policies[k], 0);
+        int before = count_mappings();
+        Matrix *m = malloc(sizeof(Matrix));
+        init_matrix(m, "M", FIRST_TOUCH_ROW_BLOCK, 500);
+        // Columns bound alike share their mappings instead of adding two each
+        ck_assert_int_lt(count_mappings() - before, 50);
+        for (int j = 0; j < m->cols; j += 99) {
+            int mode = -1;
+            unsigned long mask = 0;
+            ck_assert_int_eq(syscall(SYS_get_mempolicy, &mode, &mask, 8 * sizeof mask + 1, m->items[j].items, MPOL_F_ADDR), 0);
+            ck_assert_int_eq(mode, modes[k]);
+            ck_assert(mask & 1);
+        }
+        free_matrix(m);
+        free(m);
+    }
+    // Buffers allocated afterwards do not inherit the policy
+    set_alloc_policy(ALLOC_LOCAL, 0);
+    Vector v;
+    init_vector(&v, "V", 4 * FIRST_TOUCH_ROW_BLOCK);
+    int mode = -1;
+    unsigned long mask = 0;
+    ck_assert_int_eq(syscall(SYS_get_mempolicy, &mode, &mask, 8 * sizeof mask + 1, v.items + FIRST_TOUCH_ROW_BLOCK, MPOL_F_ADDR), 0);
+    ck_assert_int_eq(mode, MPOL_DEFAULT);
+    free_vector(&v);
+#endif
+}
+END_TEST
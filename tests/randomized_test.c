@@ -0,0 +1,139 @@
+#include <check.h>
+#include "../src/randomized.h"
+
+/**
+ * @brief compute the Frobenius norm of the difference of two matrices
+ * 
+ * @param a first matrix
+ * @param b second matrix (NULL for the norm of a alone)
+ * @return float ||a - b||_F
+ */
+float frobenius_distance(const Matrix *a, const Matrix *b) {
+    float norm = 0.0f;
+    for (int j = 0; j < a->cols; j++)
+        for (int i = 0; i < a->rows; i++) {
+            float _Complex z = a->items[j].items[i] - (b != NULL ? b->items[j].items[i] : 0.0f);
+            norm += crealf(z) * crealf(z) + cimagf(z) * cimagf(z);
+        }
+    return sqrtf(norm);
+}
+
+START_TEST(test_sampling_follows_weights)
+{
+    float weights[4] = {1.0f, 0.0f, 3.0f, 0.0f};
+    int *samples = sample_with_replacement(weights, 4, 4000);
+    int counts[4] = {0};
+    for (int t = 0; t < 4000; t++)
+        counts[samples[t]]++;
+    ck_assert_int_eq(counts[1] + counts[3], 0);
+    ck_assert_int_gt(counts[2], 2700);
+    ck_assert_int_lt(counts[2], 3300);
+    free(samples);
+}
+END_TEST
+
+START_TEST(test_approximate_matrix_mult)
+{
+    Matrix *a = create_random_complex_matrix(30, 800);
+    Matrix *b = create_random_complex_matrix(800, 20);
+    // Columns of very different scales, which importance sampling favours
+    for (int k = 0; k < 800; k += 10)
+        for (int i = 0; i < 30; i++)
+            update_matrix(a, 20.0f * a->items[k].items[i], i, k);
+
+    float epsilon = 0.3f, error;
+    ck_assert_int_lt(approximate_mult_samples(epsilon, 0.1f), 800);
+    Matrix *exact = matrix_mult(a, b);
+    Matrix *approx = approximate_matrix_mult(a, b, epsilon, 0.1f, &error);
+    float bound = epsilon * frobenius_distance(a, NULL) * frobenius_distance(b, NULL);
+    ck_assert_float_gt(error, 0.0f);
+    ck_assert_float_le(error, bound);
+    ck_assert_float_le(frobenius_distance(exact, approx), bound);
+
+    // Asking for more samples than the inner dimension gives the exact product
+    Matrix *small = create_submatrix(b, 0, 50, 0, 20);
+    Matrix *wide = create_submatrix(a, 0, 30, 0, 50);
+    Matrix *p = approximate_matrix_mult(wide, small, epsilon, 0.1f, &error);
+    Matrix *q = matrix_mult(wide, small);
+    ck_assert_float_eq(error, 0.0f);
+    ck_assert_float_le(max_abs_difference(p, q), 1e-4f);
+
+    Matrix *temporaries[] = {a, b, exact, approx, small, wide, p, q};
+    for (int i = 0; i < 8; i++) {
+        free_matrix(temporaries[i]);
+        free(temporaries[i]);
+    }
+}
+END_TEST
+
+START_TEST(test_hutchinson_trace)
+{
+    Matrix *a = create_hermitian_positive_definite_matrix(60);
+    float _Complex trace = matrix_trace(a);
+    Estimate e = hutchinson_trace(dense_matvec, a, 60, 2000);
+    ck_assert_float_gt(e.std_error, 0.0f);
+    ck_assert_float_le(cabsf(e.value - trace), 4.0f * e.std_error);
+    ck_assert_float_le(cabsf(e.value - trace), 0.05f * cabsf(trace));
+    free_matrix(a);
+    free(a);
+}
+END_TEST
+
+START_TEST(test_hutchpp_trace_of_low_rank_matrix)
+{
+    // Rank 5: the sketch captures the whole range, leaving nothing to estimate
+    Matrix *g = create_random_complex_matrix(100, 5);
+    Matrix *a = matrix_gemm(1.0f, view_of(g), view_conj_transpose(g), 0.0f, NULL);
+    float _Complex trace = matrix_trace(a);
+    Estimate e = hutchpp_trace(dense_matvec, a, 100, 30);
+    ck_assert_float_le(cabsf(e.value - trace), 1e-3f * cabsf(trace));
+    free_matrix(g); free_matrix(a);
+    free(g); free(a);
+}
+END_TEST
+
+START_TEST(test_frobenius_norm_estimates)
+{
+    Matrix *a = create_random_complex_matrix(40, 500);
+    for (int j = 0; j < 500; j++)
+        for (int i = 0; i < 40; i++)
+            update_matrix(a, (1 + j % 7) * a->items[j].items[i], i, j);
+    float norm = frobenius_distance(a, NULL);
+
+    Estimate sampled = matrix_frobenius_estimate(a, 200);
+    ck_assert_float_le(fabsf(crealf(sampled.value) - norm), 4.0f * sampled.std_error);
+    Estimate exact = matrix_frobenius_estimate(a, 500);
+    ck_assert_float_eq_tol(crealf(exact.value), norm, 1e-3f * norm);
+    ck_assert_float_eq(exact.std_error, 0.0f);
+
+    Estimate probed = operator_frobenius_estimate(dense_matvec, a, 40, 500, 300);
+    ck_assert_float_le(fabsf(crealf(probed.value) - norm), 4.0f * probed.std_error);
+    ck_assert_float_le(fabsf(crealf(probed.value) - norm), 0.1f * norm);
+    free_matrix(a);
+    free(a);
+}
+END_TEST
+
+START_TEST(test_spectral_norm_and_condition_number)
+{
+    Matrix *a = create_random_complex_matrix(80, 50);
+    Matrix *wide = create_random_complex_matrix(30, 70);
+    SVD *f = matrix_svd(a), *g = matrix_svd(wide);
+    float sigma_max = crealf(f->s->items[0]), sigma_min = crealf(f->s->items[49]);
+
+    float power = spectral_norm_power(a, 1e-6f, 500);
+    ck_assert_float_le(power, 1.001f * sigma_max);
+    ck_assert_float_ge(power, 0.99f * sigma_max);
+    ck_assert_float_eq_tol(spectral_norm_lanczos(a, 1e-6f, 50), sigma_max, 1e-3f * sigma_max);
+    ck_assert_float_eq_tol(spectral_norm_lanczos(wide, 1e-6f, 30), crealf(g->s->items[0]), 1e-3f * crealf(g->s->items[0]));
+
+    // With min(rows, cols) steps the smallest singular value is exact too
+    float kappa = condition_number_lanczos(a, 0.0f, 50);
+    ck_assert_float_eq_tol(kappa, sigma_max / sigma_min, 1e-2f * sigma_max / sigma_min);
+    ck_assert_float_le(condition_number_lanczos(a, 1e-3f, 10), 1.01f * kappa);
+
+    free_svd(f); free_svd(g);
+    free_matrix(a); free_matrix(wide);
+    free(f); free(g); free(a); free(wide);
+}
+END_TEST
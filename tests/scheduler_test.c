@@ -0,0 +1,85 @@
+#include <check.h>
+#include "../src/scheduler.h"
+
+/**
+ * @brief Increment a shared counter
+ * 
+ * @param arg atomic counter
+ */
+void increment_counter(void *arg) {
+    atomic_fetch_add((atomic_int *)arg, 1);
+}
+
+typedef struct Fibonacci {
+    int n;
+    long result;
+} Fibonacci;
+
+/**
+ * @brief Compute a Fibonacci number by spawning one task per recursive call
+ * 
+ * @param arg Fibonacci argument and result
+ */
+void fibonacci_task(void *arg) {
+    Fibonacci *f = arg;
+    if (f->n < 2) {
+        f->result = f->n;
+        return;
+    }
+    Fibonacci a = {f->n - 1, 0};
+    Fibonacci b = {f->n - 2, 0};
+    TaskGroup g;
+    init_task_group(&g);
+    task_spawn(&g, fibonacci_task, &a);
+    fibonacci_task(&b);
+    task_sync(&g);
+    f->result = a.result + b.result;
+}
+
+/**
+ * @brief Mark every index of a range as visited
+ * 
+ * @param start first index
+ * @param end last index (excluded)
+ * @param arg array of visit counters
+ */
+void mark_range(int start, int end, void *arg) {
+    atomic_int *visits = arg;
+    for (int i = start; i < end; i++)
+        atomic_fetch_add(&visits[i], 1);
+}
+
+START_TEST(test_all_spawned_tasks_are_run)
+{
+    scheduler_init(4);
+    atomic_int counter = 0;
+    TaskGroup g;
+    init_task_group(&g);
+    for (int i = 0; i < 2 * DEQUE_CAPACITY; i++)
+        task_spawn(&g, increment_counter, &counter);
+    task_sync(&g);
+    ck_assert_int_eq(atomic_load(&counter), 2 * DEQUE_CAPACITY);
+    scheduler_shutdown();
+}
+END_TEST
+
+START_TEST(test_nested_spawns_are_synchronised)
+{
+    scheduler_init(4);
+    Fibonacci f = {20, 0};
+    fibonacci_task(&f);
+    ck_assert_int_eq(f.result, 6765);
+    scheduler_shutdown();
+}
+END_TEST
+
+START_TEST(test_parallel_for_visits_each_index_once)
+{
+    scheduler_init(4);
+    atomic_int visits[1000] = {0};
+    parallel_for(0, 1000, 7, mark_range, visits);
+    for (int i = 0; i < 1000; i++)
+        ck_assert_int_eq(atomic_load(&visits[i]), 1);
+    scheduler_shutdown();
+}
+END_TEST
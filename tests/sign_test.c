@@ -0,0 +1,71 @@
+#include <check.h>
+#include "../src/sign.h"
+
+START_TEST(test_rademacher_sign_matrix_matches_dense)
+{
+    srand(7);
+    Matrix *m = rademacher_matrix(37, 11);
+    srand(7);
+    SignMatrix *s = rademacher_sign_matrix(37, 11);
+    Matrix *w = matrix_from_sign_matrix(s);
+    for (int j = 0; j < m->cols; j++)
+        for (int i = 0; i < m->rows; i++)
+            ck_assert(w->items[j].items[i] == m->items[j].items[i]);
+    free_matrix(m); free_sign_matrix(s); free_matrix(w);
+    free(m); free(s); free(w);
+}
+END_TEST
+
+START_TEST(test_sign_matrix_products)
+{
+    // Integer operands, so that every order of summation gives the exact product
+    SignMatrix *s = rademacher_sign_matrix(GEMM_KC + 45, 30);
+    Matrix *dense = matrix_from_sign_matrix(s);
+    Matrix *b = rademacher_matrix(30, 6);
+    Matrix *bt = rademacher_matrix(GEMM_KC + 45, 6);
+    update_matrix(b, 2.0f - I, 3, 1);
+    update_matrix(bt, 3.0f * I, 100, 4);
+
+    Matrix *expected = matrix_gemm(1.0f + I, view_of(dense), view_of(b), 0.0f, NULL);
+    Matrix *c = sign_matrix_gemm(1.0f + I, s, false, b, 0.0f, NULL);
+    // C = 2 (1 + i) S B - C = (1 + i) S B
+    sign_matrix_gemm(2.0f + 2.0f * I, s, false, b, -1.0f, c);
+    for (int j = 0; j < c->cols; j++)
+        for (int i = 0; i < c->rows; i++)
+            ck_assert(c->items[j].items[i] == expected->items[j].items[i]);
+
+    Matrix *expected_trans = matrix_gemm(2.0f, view_transpose(dense), view_of(bt), 0.0f, NULL);
+    Matrix *ct = sign_matrix_gemm(2.0f, s, true, bt, 0.0f, NULL);
+    for (int j = 0; j < ct->cols; j++)
+        for (int i = 0; i < ct->rows; i++)
+            ck_assert(ct->items[j].items[i] == expected_trans->items[j].items[i]);
+
+    Vector *y = sign_matrix_gemv(1.0f + I, s, false, b->items + 1, 0.0f, NULL);
+    Vector *yt = sign_matrix_gemv(2.0f, s, true, bt->items + 4, 0.0f, NULL);
+    for (int i = 0; i < y->capacity; i++)
+        ck_assert(y->items[i] == expected->items[1].items[i]);
+    for (int i = 0; i < yt->capacity; i++)
+        ck_assert(yt->items[i] == expected_trans->items[4].items[i]);
+    free_sign_matrix(s); free_matrix(dense); free_matrix(b); free_matrix(bt);
+    free_matrix(expected); free_matrix(c); free_matrix(expected_trans); free_matrix(ct);
+    free_vector(y); free_vector(yt);
+    free(s); free(dense); free(b); free(bt); free(expected); free(c); free(expected_trans); free(ct);
+    free(y); free(yt);
+}
+END_TEST
+
+START_TEST(test_integer_product_of_sign_matrices)
+{
+    SignMatrix *a = rademacher_sign_matrix(50, 300);
+    SignMatrix *b = rademacher_sign_matrix(300, 7);
+    Matrix *da = matrix_from_sign_matrix(a);
+    Matrix *db = matrix_from_sign_matrix(b);
+    Matrix *expected = matrix_gemm(1.0f, view_of(da), view_of(db), 0.0f, NULL);
+    int32_t *c = sign_matrix_mult(a, b);
+    for (int j = 0; j < b->cols; j++)
+        for (int i = 0; i < a->rows; i++)
+            ck_assert(c[j * a->rows + i] == expected->items[j].items[i]);
+    free_sign_matrix(a); free_sign_matrix(b); free_matrix(da); free_matrix(db); free_matrix(expected);
+    free(a); free(b); free(da); free(db); free(expected); free(c);
+}
+END_TEST
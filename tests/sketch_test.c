@@ -0,0 +1,101 @@
+#include <check.h>
+#include "../src/sketch.h"
+
+/**
+ * @brief compute the covariance error ||A^H A - B^H B||_2 of a sketch B of A
+ * 
+ * @param a sketched matrix
+ * @param b sketch
+ * @return float spectral norm of the difference of the Gram matrices
+ */
+float covariance_error(const Matrix *a, const Matrix *b) {
+    Matrix *gram = matrix_gemm(1.0f, view_conj_transpose(a), view_of(a), 0.0f, NULL);
+    matrix_gemm(-1.0f, view_conj_transpose(b), view_of(b), 1.0f, gram);
+    float error = spectral_norm_lanczos(gram, 0.0f, gram->cols);
+    free_matrix(gram);
+    free(gram);
+    return error;
+}
+
+START_TEST(test_frequent_directions_bound)
+{
+    // Decaying column scales, so that few directions carry most of the energy
+    Matrix *a = create_random_complex_matrix(600, 40);
+    for (int j = 0; j < 40; j++)
+        for (int i = 0; i < 600; i++)
+            update_matrix(a, a->items[j].items[i] / (1 + j), i, j);
+    float squared_norm = frobenius_distance(a, NULL) * frobenius_distance(a, NULL);
+
+    // Row by row and in one batch, which must give the same sketch
+    FrequentDirections single, batched;
+    init_frequent_directions(&single, 8, 40);
+    init_frequent_directions(&batched, 8, 40);
+    Vector row;
+    init_vector(&row, "r", 40);
+    for (int i = 0; i < 600; i++) {
+        for (int j = 0; j < 40; j++)
+            row.items[j] = a->items[j].items[i];
+        frequent_directions_insert(&single, &row);
+    }
+    frequent_directions_insert_rows(&batched, a);
+
+    Matrix *b = frequent_directions_sketch(&single);
+    Matrix *c = frequent_directions_sketch(&batched);
+    ck_assert_int_eq(b->rows, 8);
+    ck_assert_float_le(max_abs_difference(b, c), 1e-3f);
+    float error = covariance_error(a, b);
+    ck_assert_float_le(error, 1.001f * single.shrinkage);
+    ck_assert_float_le(single.shrinkage, squared_norm / 8);
+
+    free_frequent_directions(&single); free_frequent_directions(&batched);
+    free_vector(&row);
+    free_matrix(a); free_matrix(b); free_matrix(c);
+    free(a); free(b); free(c);
+}
+END_TEST
+
+START_TEST(test_merged_frequent_directions)
+{
+    Matrix *a = create_random_complex_matrix(400, 30);
+    Matrix top, bottom;
+    init_matrix_view(&top, a, 0, 250, 0, 30);
+    init_matrix_view(&bottom, a, 250, 400, 0, 30);
+
+    // Two workers sketch half of the stream each
+    FrequentDirections first, second;
+    init_frequent_directions(&first, 10, 30);
+    init_frequent_directions(&second, 10, 30);
+    frequent_directions_insert_rows(&first, &top);
+    frequent_directions_insert_rows(&second, &bottom);
+    frequent_directions_merge(&first, &second);
+
+    Matrix *b = frequent_directions_sketch(&first);
+    float squared_norm = frobenius_distance(a, NULL) * frobenius_distance(a, NULL);
+    ck_assert_float_le(covariance_error(a, b), squared_norm / 10);
+
+    free_frequent_directions(&first); free_frequent_directions(&second);
+    free_matrix_view(&top); free_matrix_view(&bottom);
+    free_matrix(a); free_matrix(b);
+    free(a); free(b);
+}
+END_TEST
+
+START_TEST(test_sign_sketch_preserves_norms)
+{
+    Matrix *a = create_random_complex_matrix(500, 20);
+    for (int j = 0; j < 20; j++)
+        for (int i = 0; i < 500; i++)
+            update_matrix(a, a->items[j].items[i] * (1 + j % 4), i, j);
+    // Each squared column norm is estimated with a relative deviation of about
+    // sqrt(2 / k), i.e. 4.5% here
+    Matrix *b = sign_sketch(a, 1000);
+    ck_assert_int_eq(b->rows, 1000);
+    ck_assert_int_eq(b->cols, 20);
+    for (int j = 0; j < 20; j++) {
+        float expected = vector_L2_norm(a->items + j), norm = vector_L2_norm(b->items + j);
+        ck_assert_float_le(fabsf(norm / expected - 1.0f), 0.2f);
+    }
+    free_matrix(a); free_matrix(b);
+    free(a); free(b);
+}
+END_TEST
@@ -0,0 +1,166 @@
+#include <check.h>
+#include "../src/sparse.h"
+
+/**
+ * @brief Create a random complex matrix in which most elements are zero
+ * 
+ * @param rows # of rows
+ * @param cols # of columns
+ * @param density probability for an element to be nonzero
+ * @return Matrix* dense storage of the sparse matrix
+ */
+Matrix *create_sparse_random_matrix(int rows, int cols, float density) {
+    Matrix *m = create_random_complex_matrix(rows, cols);
+    for (int j = 0; j < cols; j++)
+        for (int i = 0; i < rows; i++)
+            if (rand() >= density * RAND_MAX)
+                update_matrix(m, 0.0f, i, j);
+    return m;
+}
+
+START_TEST(test_sparse_dense_round_trip)
+{
+    Matrix *m = create_sparse_random_matrix(70, 45, 0.05f);
+    SparseMatrix *csr = sparse_from_dense(m, SPARSE_CSR);
+    SparseMatrix *csc = sparse_convert(csr, SPARSE_CSC);
+    ck_assert_int_eq(csr->nnz, csc->nnz);
+    ck_assert_int_eq(csr->ptr[70], csr->nnz);
+    ck_assert_int_eq(csc->ptr[45], csc->nnz);
+
+    Matrix *from_csr = sparse_to_dense(csr);
+    Matrix *from_csc = sparse_to_dense(csc);
+    ck_assert_float_eq(max_abs_difference(from_csr, m), 0.0f);
+    ck_assert_float_eq(max_abs_difference(from_csc, m), 0.0f);
+    free_sparse_matrix(csr); free_sparse_matrix(csc);
+    free_matrix(m); free_matrix(from_csr); free_matrix(from_csc);
+    free(csr); free(csc); free(m); free(from_csr); free(from_csc);
+}
+END_TEST
+
+START_TEST(test_sparse_transpose)
+{
+    Matrix *m = create_sparse_random_matrix(30, 55, 0.1f);
+    SparseMatrix *s = sparse_from_dense(m, SPARSE_CSR);
+    SparseMatrix *st = sparse_transpose(s);
+    ck_assert_int_eq(st->rows, 55);
+    ck_assert_int_eq(st->cols, 30);
+    ck_assert(st->format == SPARSE_CSR);
+
+    Matrix *dense = sparse_to_dense(st);
+    Matrix *mt = matrix_transpose(m);
+    ck_assert_float_eq(max_abs_difference(dense, mt), 0.0f);
+    free_sparse_matrix(s); free_sparse_matrix(st); free_matrix(m); free_matrix(dense); free_matrix(mt);
+    free(s); free(st); free(m); free(dense); free(mt);
+}
+END_TEST
+
+START_TEST(test_sparse_matrix_vector_product)
+{
+    Matrix *m = create_sparse_random_matrix(300, 1000, 0.01f);
+    Matrix *x = create_random_complex_matrix(1000, 1);
+    Matrix *expected = matrix_mult(m, x);
+    for (SparseFormat format = SPARSE_CSR; format <= SPARSE_CSC; format++) {
+        SparseMatrix *s = sparse_from_dense(m, format);
+        Vector *y = sparse_mult_vector(s, &x->items[0]);
+        for (int i = 0; i < 300; i++)
+            ck_assert_float_le(cabsf(y->items[i] - expected->items[0].items[i]), 1e-4f);
+        free_sparse_matrix(s); free_vector(y);
+        free(s); free(y);
+    }
+    free_matrix(m); free_matrix(x); free_matrix(expected);
+    free(m); free(x); free(expected);
+}
+END_TEST
+
+START_TEST(test_sparse_matrix_dense_matrix_product)
+{
+    Matrix *m = create_sparse_random_matrix(80, 120, 0.05f);
+    Matrix *b = create_random_complex_matrix(120, 9);
+    Matrix *expected = matrix_mult(m, b);
+    for (SparseFormat format = SPARSE_CSR; format <= SPARSE_CSC; format++) {
+        SparseMatrix *s = sparse_from_dense(m, format);
+        Matrix *r = sparse_mult_matrix(s, b);
+        ck_assert_float_le(max_abs_difference(r, expected), 1e-4f);
+        free_sparse_matrix(s); free_matrix(r);
+        free(s); free(r);
+    }
+    free_matrix(m); free_matrix(b); free_matrix(expected);
+    free(m); free(b); free(expected);
+}
+END_TEST
+
+/**
+ * @brief Create a random sparse vector
+ * 
+ * @param capacity dimension of the vector
+ * @param nnz number of random coordinates (repeated ones are merged)
+ * @return SparseVector* the sparse vector
+ */
+SparseVector *create_random_sparse_vector(int capacity, int nnz) {
+    int *indices = malloc(nnz * sizeof *indices);
+    float _Complex *values = malloc(nnz * sizeof *values);
+    for (int k = 0; k < nnz; k++) {
+        indices[k] = rand() % capacity;
+        values[k] = (rand() % 2 ? 1.0f : -1.0f) + (rand() % 2 ? 1.0f : -1.0f) * I;
+    }
+    SparseVector *u = sparse_vector_from_arrays(capacity, nnz, indices, values);
+    free(indices); free(values);
+    return u;
+}
+
+START_TEST(test_sparse_vector_from_unsorted_arrays)
+{
+    int indices[] = {7, 2, 9, 2, 0};
+    float _Complex values[] = {1, 2, 3*I, 4, 5};
+    SparseVector *u = sparse_vector_from_arrays(10, 5, indices, values);
+    ck_assert_int_eq(u->nnz, 4);
+    int expected[] = {0, 2, 7, 9};
+    for (int k = 0; k < 4; k++)
+        ck_assert_int_eq(u->indices[k], expected[k]);
+    ck_assert(u->values[1] == 6);
+
+    Vector *v = sparse_vector_to_dense(u);
+    SparseVector *w = sparse_vector_from_dense(v);
+    ck_assert_int_eq(w->nnz, 4);
+    ck_assert(v->items[9] == 3*I && w->values[3] == 3*I);
+    free_sparse_vector(u); free_sparse_vector(w); free_vector(v);
+    free(u); free(w); free(v);
+}
+END_TEST
+
+START_TEST(test_sparse_dense_inner_product_and_norms)
+{
+    SparseVector *u = create_random_sparse_vector(5000, 203);
+    Vector *dense_u = sparse_vector_to_dense(u);
+    Vector *v = rademacher_vector(5000);
+    for (int i = 0; i < 5000; i += 3)
+        update_vector(v, v->items[i] * I, i);
+
+    ck_assert_float_le(cabsf(sparse_dense_inner_product(u, v) - vector_inner_product(dense_u, v)), 1e-3f);
+    ck_assert_float_eq_tol(sparse_vector_L1_norm(u), vector_L1_norm(dense_u), 1e-3f);
+    ck_assert_float_eq_tol(sparse_vector_L2_norm(u), vector_L2_norm(dense_u), 1e-3f);
+    ck_assert_float_eq_tol(sparse_vector_Lp_norm(u, 3), vector_Lp_norm(dense_u, 3), 1e-3f);
+
+    sparse_scatter_add(v, 2.0f, u);
+    for (int k = 0; k < u->nnz; k++)
+        ck_assert(cabsf(v->items[u->indices[k]]) > 0.0f);
+    free_sparse_vector(u); free_vector(dense_u); free_vector(v);
+    free(u); free(dense_u); free(v);
+}
+END_TEST
+
+START_TEST(test_sparse_sparse_inner_product)
+{
+    // Similar sizes are merged, very different ones galloped
+    int sizes[][2] = {{300, 250}, {20, 2000}, {2000, 20}};
+    for (int t = 0; t < 3; t++) {
+        SparseVector *u = create_random_sparse_vector(4000, sizes[t][0]);
+        SparseVector *v = create_random_sparse_vector(4000, sizes[t][1]);
+        Vector *dense_v = sparse_vector_to_dense(v);
+        float _Complex expected = sparse_dense_inner_product(u, dense_v);
+        ck_assert_float_le(cabsf(sparse_inner_product(u, v) - expected), 1e-3f);
+        free_sparse_vector(u); free_sparse_vector(v); free_vector(dense_v);
+        free(u); free(v); free(dense_v);
+    }
+}
+END_TEST
@@ -0,0 +1,87 @@
+#include <check.h>
+#include "../src/svd.h"
+
+/**
+ * @brief Rebuild U diag(s) V^H from a singular value decomposition
+ * 
+ * @param f decomposition
+ * @return Matrix* the product of the factors
+ */
+Matrix *svd_reconstruct(const SVD *f) {
+    Matrix *us = matrix_copy(f->u);
+    for (int j = 0; j < us->cols; j++)
+        for (int i = 0; i < us->rows; i++)
+            us->items[j].items[i] *= f->s->items[j];
+    Matrix *m = matrix_gemm(1.0f, view_of(us), view_conj_transpose(f->v), 0.0f, NULL);
+    free_matrix(us);
+    free(us);
+    return m;
+}
+
+/**
+ * @brief Check that the singular values are non-negative and in descending order
+ * 
+ * @param f decomposition
+ * @return true if the singular values are sorted
+ * @return false otherwise
+ */
+bool singular_values_are_sorted(const SVD *f) {
+    for (int i = 0; i < f->s->capacity; i++)
+        if (crealf(f->s->items[i]) < 0.0f || (i > 0 && crealf(f->s->items[i]) > crealf(f->s->items[i-1])))
+            return false;
+    return true;
+}
+
+START_TEST(test_svd_of_tall_matrix)
+{
+    Matrix *a = create_random_complex_matrix(40, 25);
+    SVD *f = matrix_svd(a);
+    ck_assert_int_eq(f->s->capacity, 25);
+    ck_assert(singular_values_are_sorted(f));
+
+    Matrix *r = svd_reconstruct(f);
+    ck_assert_float_le(max_abs_difference(r, a), 1e-4f);
+    Matrix *uh = matrix_conj_transpose(f->u);
+    Matrix *gram = matrix_mult(uh, f->u);
+    Matrix *id = identity_matrix(25);
+    ck_assert_float_le(max_abs_difference(gram, id), 1e-4f);
+    free_svd(f); free_matrix(a); free_matrix(r); free_matrix(uh); free_matrix(gram); free_matrix(id);
+    free(f); free(a); free(r); free(uh); free(gram); free(id);
+}
+END_TEST
+
+START_TEST(test_svd_of_wide_matrix)
+{
+    Matrix *a = create_random_complex_matrix(12, 30);
+    SVD *f = matrix_svd(a);
+    ck_assert_int_eq(f->u->rows, 12);
+    ck_assert_int_eq(f->v->rows, 30);
+    ck_assert(singular_values_are_sorted(f));
+    Matrix *r = svd_reconstruct(f);
+    ck_assert_float_le(max_abs_difference(r, a), 1e-4f);
+    free_svd(f); free_matrix(a); free_matrix(r);
+    free(f); free(a); free(r);
+}
+END_TEST
+
+START_TEST(test_randomized_svd_of_low_rank_matrix)
+{
+    // Product of 150x5 and 5x90 factors: the rank-5 approximation is exact
+    Matrix *b = create_random_complex_matrix(150, 5);
+    Matrix *c = create_random_complex_matrix(5, 90);
+    Matrix *a = matrix_mult(b, c);
+    SVD *f = randomized_svd(a, 5, 5, 1);
+    ck_assert_int_eq(f->u->cols, 5);
+    ck_assert_int_eq(f->v->cols, 5);
+    ck_assert_int_eq(f->s->capacity, 5);
+    ck_assert(singular_values_are_sorted(f));
+
+    Matrix *r = svd_reconstruct(f);
+    ck_assert_float_le(max_abs_difference(r, a), 1e-3f);
+    SVD *exact = matrix_svd(a);
+    for (int i = 0; i < 5; i++)
+        ck_assert_float_le(cabsf(f->s->items[i] - exact->s->items[i]), 1e-3f * crealf(exact->s->items[0]));
+    free_svd(f); free_svd(exact); free_matrix(a); free_matrix(b); free_matrix(c); free_matrix(r);
+    free(f); free(exact); free(a); free(b); free(c); free(r);
+}
+END_TEST
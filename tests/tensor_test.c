@@ -1,5 +1,5 @@
 #include <check.h>
-#include "../src/tensor.h"
+#include "../src/expression.h"
 
 
 /**
@@ -106,4 +106,55 @@ START_TEST(test_standard_tensor_elementwise_multiplication)
                 ck_assert_float_eq(T->items[n_3].items[n_2].items[n_1], 1.0f);
     free_tensor(E); free_tensor(F); free_tensor(T);
     free(E); free(F); free(T);
-}
\ No newline at end of file
+}
+END_TEST
+
+START_TEST(test_fused_tensor_expression)
+{
+    // Several chunks per column, and a matrix broadcast along the depth
+    Tensor *E = malloc(sizeof(Tensor)), *F = malloc(sizeof(Tensor));
+    init_tensor(E, "E", 300, 5, 3);
+    init_tensor(F, "F", 300, 5, 3);
+    for (int n_3 = 0; n_3 < 3; n_3++) {
+        Matrix *a = gaussian_matrix(300, 5), *b = gaussian_matrix(300, 5);
+        for (int n_2 = 0; n_2 < 5; n_2++)
+            for (int n_1 = 0; n_1 < 300; n_1++) {
+                update_tensor(E, a->items[n_2].items[n_1], n_1, n_2, n_3);
+                update_tensor(F, b->items[n_2].items[n_1] * I, n_1, n_2, n_3);
+            }
+        free_matrix(a); free_matrix(b);
+        free(a); free(b);
+    }
+    Matrix *M = gaussian_matrix(300, 5);
+
+    Expr *e = expr_hadamard(expr_add(expr_scale(expr_tensor(E), 2.0f * I), expr_conj(expr_tensor(F)), false), expr_matrix(M));
+    Tensor *T = expr_eval_tensor(e);
+    ck_assert_int_eq(T->depth, 3);
+    for (int n_3 = 0; n_3 < 3; n_3++)
+        for (int n_2 = 0; n_2 < 5; n_2++)
+            for (int n_1 = 0; n_1 < 300; n_1++) {
+                float _Complex expected = (2.0f * I * E->items[n_3].items[n_2].items[n_1] - conjf(F->items[n_3].items[n_2].items[n_1])) * M->items[n_2].items[n_1];
+                ck_assert_float_le(cabsf(T->items[n_3].items[n_2].items[n_1] - expected), 1e-5f);
+            }
+    free_expr(e);
+    free_tensor(E); free_tensor(F); free_tensor(T); free_matrix(M);
+    free(E); free(F); free(T); free(M);
+}
+END_TEST
+
+START_TEST(test_fused_matrix_expression_in_place)
+{
+    Matrix *A = gaussian_matrix(7, 4), *B = gaussian_matrix(7, 4);
+    Matrix *C = create_submatrix(A, 0, 7, 0, 4);
+
+    // A = A - 3B, A being both an operand and the destination
+    Expr *e = expr_add(expr_matrix(A), expr_scale(expr_matrix(B), 3.0f), false);
+    expr_eval_into(e, A);
+    for (int j = 0; j < 4; j++)
+        for (int i = 0; i < 7; i++)
+            ck_assert_float_le(cabsf(A->items[j].items[i] - (C->items[j].items[i] - 3.0f * B->items[j].items[i])), 1e-5f);
+    free_expr(e);
+    free_matrix(A); free_matrix(B); free_matrix(C);
+    free(A); free(B); free(C);
+}
+END_TEST
@@ -199,6 +199,20 @@ START_TEST(test_standard_vector_L2_norm)
 }
 END_TEST
 
+START_TEST(test_vector_view_shares_storage)
+{
+    Vector *u = rademacher_vector(10);
+    Vector view;
+    init_vector_view(&view, u, 2, 7);
+    ck_assert_int_eq(view.capacity, 5);
+    ck_assert_float_eq(vector_L1_norm(&view), 5.0f);
+    update_vector(&view, 3.0f, 0);
+    ck_assert(u->items[2] == 3.0f);
+    free_vector(u);
+    free(u);
+}
+END_TEST
+
 START_TEST(test_first_level_vector_Lp_norm)
 {
     Vector *u = create_dummy_real_vector(2.0f);